@@ -4,7 +4,7 @@
 #
 #-------------------------------------------------
 
-QT       += core gui
+QT       += core gui concurrent
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
 TARGET = GameMakerLinux
@@ -12,6 +12,9 @@ TEMPLATE = app
 
 CONFIG += qscintilla2 c++14
 
+# the room export streams its PNG with zlib
+LIBS += -lz
+
 # The following define makes your compiler emit warnings if you use
 # any feature of Qt which has been marked as deprecated (the exact warnings
 # depend on your compiler). Please consult the documentation of the
@@ -73,7 +76,34 @@ SOURCES += \
     models/sortedeventsmodel.cpp \
     resources/projectresource.cpp \
     utils/flowlayout.cpp \
-    widgets/formedit.cpp
+    widgets/formedit.cpp \
+    utils/jsonwriter.cpp \
+    utils/editjournal.cpp \
+    utils/localhistory.cpp \
+    widgets/historydialog.cpp \
+    graphics/spatialgrid.cpp \
+    graphics/spritecache.cpp \
+    graphics/graphicsroomview.cpp \
+    resources/tilesetresourceitem.cpp \
+    resources/dependencies/tilelayer.cpp \
+    graphics/graphicstilechunk.cpp \
+    graphics/graphicsbackground.cpp \
+    editors/roomcommands.cpp \
+    graphics/roomrenderer.cpp \
+    utils/pngwriter.cpp \
+    widgets/roomminimap.cpp \
+    docks/minimapdock.cpp \
+    graphics/spriteanimator.cpp \
+    widgets/spritepreview.cpp \
+    resources/dependencies/instanceindex.cpp \
+    models/searchresultsmodel.cpp \
+    widgets/instancesearch.cpp \
+    graphics/roomanalysis.cpp \
+    widgets/roomanalysisdialog.cpp \
+    resources/dependencies/roomview.cpp \
+    resources/dependencies/roomviewsettings.cpp \
+    resources/dependencies/roomphysicssettings.cpp \
+    widgets/camerapreview.cpp
 
 HEADERS += \
         mainwindow.h \
@@ -125,7 +155,34 @@ HEADERS += \
     models/sortedeventsmodel.h \
     resources/projectresource.h \
     utils/flowlayout.h \
-    widgets/formedit.h
+    widgets/formedit.h \
+    utils/jsonwriter.h \
+    utils/editjournal.h \
+    utils/localhistory.h \
+    widgets/historydialog.h \
+    graphics/spatialgrid.h \
+    graphics/spritecache.h \
+    graphics/graphicsroomview.h \
+    resources/tilesetresourceitem.h \
+    resources/dependencies/tilelayer.h \
+    graphics/graphicstilechunk.h \
+    graphics/graphicsbackground.h \
+    editors/roomcommands.h \
+    graphics/roomrenderer.h \
+    utils/pngwriter.h \
+    widgets/roomminimap.h \
+    docks/minimapdock.h \
+    graphics/spriteanimator.h \
+    widgets/spritepreview.h \
+    resources/dependencies/instanceindex.h \
+    models/searchresultsmodel.h \
+    widgets/instancesearch.h \
+    graphics/roomanalysis.h \
+    widgets/roomanalysisdialog.h \
+    resources/dependencies/roomview.h \
+    resources/dependencies/roomviewsettings.h \
+    resources/dependencies/roomphysicssettings.h \
+    widgets/camerapreview.h
 
 FORMS += \
         mainwindow.ui \
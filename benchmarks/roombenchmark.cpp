@@ -0,0 +1,180 @@
+/*
+    Copyright (C) 2018  Alexander Roper
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "graphics/roomrenderer.h"
+#include "graphics/spritecache.h"
+#include "resources/roomresourceitem.h"
+#include "resources/objectresourceitem.h"
+#include "resources/spriteresourceitem.h"
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QPainter>
+#include <QPixmap>
+#include <QTextStream>
+#include <QUuid>
+#include <QtMath>
+#include <algorithm>
+
+// in pixels, the size of the visible region rendered for each frame
+static const QSize VIEWPORT_SIZE(1920, 1080);
+static const int FRAMES = 20;
+
+static QString newId()
+{
+    return QUuid::createUuid().toString().mid(1, 36);
+}
+
+static SpriteResourceItem * createSprite(QString name, QColor colour)
+{
+    QJsonObject image;
+    image["id"] = newId();
+    image["FrameId"] = newId();
+    QJsonObject frame;
+    frame["id"] = image["FrameId"];
+    frame["compositeImage"] = image;
+
+    QJsonObject json;
+    json["name"] = name;
+    json["xorig"] = 16;
+    json["yorig"] = 16;
+    json["frames"] = QJsonArray { frame };
+
+    auto sprite = qobject_cast<SpriteResourceItem*>(ResourceItem::create(ResourceType::Sprite, newId()));
+    sprite->load(json);
+
+    // there is no file, the frame is put in the cache instead
+    QPixmap pix(32, 32);
+    pix.fill(colour);
+    SpriteCache::insert(sprite, 0, pix);
+    return sprite;
+}
+
+static RoomResourceItem * createRoom(int count, SpriteResourceItem * background, ObjectResourceItem * object)
+{
+    // the density of instances stays the same whatever their count
+    int side = qCeil(qSqrt(count)) * 64;
+
+    QJsonObject settings;
+    settings["id"] = newId();
+    settings["Width"] = side;
+    settings["Height"] = side;
+
+    QJsonObject bgLayer;
+    bgLayer["modelName"] = "GMRBackgroundLayer";
+    bgLayer["id"] = newId();
+    bgLayer["name"] = "Background";
+    bgLayer["depth"] = 100;
+    bgLayer["spriteId"] = background->id();
+    bgLayer["htiled"] = true;
+    bgLayer["vtiled"] = true;
+
+    QJsonArray instances;
+    for (int i = 0; i < count; i++)
+    {
+        QJsonObject instance;
+        instance["id"] = newId();
+        instance["name"] = QString("inst_%1").arg(i);
+        instance["x"] = qrand() % side;
+        instance["y"] = qrand() % side;
+        instance["objId"] = object->id();
+        instances.append(instance);
+    }
+
+    QJsonObject instLayer;
+    instLayer["modelName"] = "GMRInstanceLayer";
+    instLayer["id"] = newId();
+    instLayer["name"] = "Instances";
+    instLayer["depth"] = 0;
+    instLayer["instances"] = instances;
+
+    QJsonObject json;
+    json["name"] = QString("room_%1").arg(count);
+    json["roomSettings"] = settings;
+    json["layers"] = QJsonArray { bgLayer, instLayer };
+
+    auto room = qobject_cast<RoomResourceItem*>(ResourceItem::create(ResourceType::Room, newId()));
+    room->load(json);
+    return room;
+}
+
+static qreal median(QVector<qreal> values)
+{
+    std::sort(values.begin(), values.end());
+    return values[values.size() / 2];
+}
+
+int main(int argc, char *argv[])
+{
+    // no display is needed
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication a(argc, argv);
+    qsrand(42);
+
+    QVector<int> counts;
+    for (auto & arg : a.arguments().mid(1))
+        counts.append(arg.toInt());
+    if (counts.isEmpty())
+        counts = { 1000, 10000, 100000 };
+
+    auto background = createSprite("spr_background", Qt::darkGreen);
+    auto sprite = createSprite("spr_instance", Qt::red);
+    auto object = qobject_cast<ObjectResourceItem*>(ResourceItem::create(ResourceType::Object, newId()));
+    object->load({ { "name", "obj_instance" }, { "spriteId", sprite->id() } });
+
+    QTextStream out(stdout);
+    out << "instances\tscale\tbuild (ms)\tfirst (ms)\tmedian (ms)\tmax (ms)" << endl;
+
+    for (auto count : counts)
+    {
+        QElapsedTimer timer;
+        timer.start();
+        auto room = createRoom(count, background, object);
+        RoomRenderer renderer(room);
+        qreal build = timer.nsecsElapsed() / 1e6;
+
+        for (qreal scale : { 1.0, 0.5, 0.1 })
+        {
+            QImage image(VIEWPORT_SIZE, QImage::Format_ARGB32_Premultiplied);
+            QSizeF regionSize = QSizeF(VIEWPORT_SIZE) / scale;
+
+            // the region pans across the room, like a scrolling view
+            QVector<qreal> times;
+            for (int i = 0; i < FRAMES; i++)
+            {
+                QPointF topLeft((renderer.roomSize().width() - regionSize.width()) * i / FRAMES, 0);
+                QRectF region(topLeft, regionSize);
+
+                timer.restart();
+                image.fill(Qt::transparent);
+                QPainter painter(&image);
+                painter.scale(scale, scale);
+                painter.translate(-region.topLeft());
+                renderer.render(&painter, region);
+                painter.end();
+                times.append(timer.nsecsElapsed() / 1e6);
+            }
+
+            out << count << '\t' << scale << '\t' << build << '\t' << times.first() << '\t'
+                << median(times) << '\t' << *std::max_element(times.begin(), times.end()) << endl;
+        }
+    }
+
+    return 0;
+}
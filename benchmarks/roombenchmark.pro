@@ -0,0 +1,39 @@
+#-------------------------------------------------
+#
+# Renders synthetic rooms offscreen and reports the frame times
+#
+#-------------------------------------------------
+
+QT       += core gui widgets concurrent
+
+TARGET = roombenchmark
+TEMPLATE = app
+
+CONFIG += c++14 console
+CONFIG -= app_bundle
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+INCLUDEPATH += ..
+LIBS += -lz
+
+SOURCES += \
+    roombenchmark.cpp \
+    ../gamesettings.cpp \
+    ../utils/utils.cpp \
+    ../utils/uuid.cpp \
+    ../utils/jsonwriter.cpp \
+    ../utils/pngwriter.cpp \
+    $$files(../resources/*.cpp) \
+    $$files(../resources/dependencies/*.cpp) \
+    $$files(../graphics/*.cpp)
+
+HEADERS += \
+    ../gamesettings.h \
+    ../utils/utils.h \
+    ../utils/uuid.h \
+    ../utils/jsonwriter.h \
+    ../utils/pngwriter.h \
+    $$files(../resources/*.h) \
+    $$files(../resources/dependencies/*.h) \
+    $$files(../graphics/*.h)
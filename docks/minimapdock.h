@@ -0,0 +1,39 @@
+/*
+    Copyright (C) 2018  Alexander Roper
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef MINIMAPDOCK_H
+#define MINIMAPDOCK_H
+
+#include <QDockWidget>
+
+class GraphicsRoomView;
+class RoomMinimap;
+class MinimapDock : public QDockWidget
+{
+    Q_OBJECT
+
+public:
+    MinimapDock();
+
+    // the room of the view is shown, nothing for a null view
+    void setView(GraphicsRoomView * view);
+
+private:
+    RoomMinimap * minimap;
+};
+
+#endif // MINIMAPDOCK_H
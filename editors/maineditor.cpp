@@ -38,11 +38,25 @@ MainEditor::~MainEditor()
     delete ui;
 }
 
+void MainEditor::replay(const QJsonObject & entry)
+{
+    Q_UNUSED(entry)
+}
+
+void MainEditor::discardChanges()
+{
+}
+
 void MainEditor::setWidget(QWidget * widget)
 {
     targetLayout->addWidget(widget);
 }
 
+QPushButton * MainEditor::addButton(QString text)
+{
+    return ui->buttonBox->addButton(text, QDialogButtonBox::ActionRole);
+}
+
 void MainEditor::setDirty(bool b)
 {
     if (dirty != b)
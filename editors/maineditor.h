@@ -19,12 +19,14 @@
 #define MAINEDITOR_H
 
 #include <QWidget>
+#include <QJsonObject>
 #include "resources/resourceitem.h"
 
 namespace Ui {
 class MainEditor;
 }
 
+class QPushButton;
 class MainEditor : public QWidget
 {
     Q_OBJECT
@@ -35,9 +37,16 @@ public:
 
     bool isDirty() const { return dirty; }
 
+    // apply an entry of the edit journal (see journalEntry)
+    virtual void replay(const QJsonObject & entry);
+    // called when the editor is closed without saving, for the editors
+    // which change their resource before it is saved
+    virtual void discardChanges();
+
 signals:
     void dirtyChanged(bool);
     void saved();
+    void journalEntry(QJsonObject entry);
 
 public slots:
     virtual void save() = 0;
@@ -45,6 +54,7 @@ public slots:
 
 protected:
     void setWidget(QWidget * widget);
+    QPushButton * addButton(QString text);
 
     template <typename T>
     T * item()
@@ -23,8 +23,13 @@
 #include "resources/spriteresourceitem.h"
 #include "models/sortedeventsmodel.h"
 #include "utils/flowlayout.h"
+#include "utils/localhistory.h"
+#include "widgets/historydialog.h"
 #include <QDir>
+#include <QJsonDocument>
 #include <QDebug>
+#include <QMessageBox>
+#include <QFutureWatcher>
 
 struct EventTypeAndNumber {
     ObjectEvent::EventType type;
@@ -133,8 +138,51 @@ ObjectEditor::ObjectEditor(ObjectResourceItem* item)
     });
     connect(ui->eventsListView, &QListView::customContextMenuRequested, this, &ObjectEditor::showEventsContextMenu);
 
-    connect(ui->nameLineEdit, &QLineEdit::textEdited, [this](QString) {
+    connect(ui->nameLineEdit, &QLineEdit::textEdited, [this](QString text) {
         this->setDirty();
+        this->journalProperty("name", text);
+    });
+
+    // EDIT JOURNAL
+    m_journaledCheckBoxes = {
+        { "visible", ui->visibleCheckBox },
+        { "solid", ui->solidCheckBox },
+        { "persistent", ui->persistentCheckBox },
+        { "physics", ui->usesPhysicsCheckBox },
+        { "sensor", ui->sensorCheckBox },
+        { "startAwake", ui->startAwakeCheckBox },
+        { "kinematic", ui->kinematicCheckBox }
+    };
+    for (auto it = m_journaledCheckBoxes.begin(); it != m_journaledCheckBoxes.end(); ++it)
+    {
+        auto name = it.key();
+        auto checkBox = it.value();
+        connect(checkBox, &QCheckBox::released, this, [this, name, checkBox]() {
+            journalProperty(name, checkBox->isChecked());
+        });
+    }
+
+    m_journaledEdits = {
+        { "density", m_density },
+        { "restitution", m_restitution },
+        { "collisionGroup", m_collisionGroup },
+        { "linearDamping", m_linearDamping },
+        { "angularDamping", m_angularDamping },
+        { "friction", m_friction }
+    };
+    for (auto it = m_journaledEdits.begin(); it != m_journaledEdits.end(); ++it)
+    {
+        auto name = it.key();
+        auto edit = it.value();
+        connect(edit, &FormEdit::editingFinished, this, [this, name, edit]() {
+            journalProperty(name, edit->text());
+        });
+    }
+
+    // the edits done during a save are not in its files
+    connect(this, &MainEditor::journalEntry, this, [this](QJsonObject entry) {
+        if (m_saving)
+            m_journaledWhileSaving.push_back(entry);
     });
 
     reset();
@@ -158,6 +206,66 @@ void ObjectEditor::refreshChildren()
     }
 }
 
+void ObjectEditor::replay(const QJsonObject & entry)
+{
+    if (entry["op"].toString() == "property")
+    {
+        auto name = entry["name"].toString();
+        auto value = entry["value"];
+        if (m_journaledCheckBoxes.contains(name))
+        {
+            m_journaledCheckBoxes[name]->setChecked(value.toBool());
+        }
+        else if (m_journaledEdits.contains(name))
+        {
+            m_journaledEdits[name]->setText(value.toString());
+        }
+        else if (name == "name")
+        {
+            ui->nameLineEdit->setText(value.toString());
+        }
+        else
+        {
+            auto id = value.toString();
+            auto pItem = Uuid::isNull(id) ? nullptr : ResourceItem::get(id);
+            if (name == "parent")
+            {
+                m_parentObject = qobject_cast<ObjectResourceItem*>(pItem);
+                ui->parentLineEdit->setText(pItem ? pItem->name() : QString());
+            }
+            else if (name == "sprite")
+            {
+                m_sprite = qobject_cast<SpriteResourceItem*>(pItem);
+                ui->spriteViewer->setIcon(m_sprite ? QIcon(m_sprite->thumbnail()) : QIcon());
+            }
+            else if (name == "mask")
+            {
+                m_maskSprite = qobject_cast<SpriteResourceItem*>(pItem);
+                ui->maskLineEdit->setText(pItem ? pItem->name() : QString());
+            }
+        }
+
+        setDirty();
+        // journaled again, the previous journal is gone
+        emit journalEntry(entry);
+    }
+    else
+    {
+        // code edit of an event
+        auto eventId = entry["event"].toString();
+        for (int i = 0; i < eventsModel.rowCount(); i++)
+        {
+            if (eventsModel.event(i)->id() == eventId)
+            {
+                auto editor = qobject_cast<CodeEditor*>(ui->stackedCodeEditorWidget->widget(i));
+                if (editor)
+                    editor->replay(entry);
+                break;
+            }
+        }
+    }
+}
+
 void ObjectEditor::save()
 {
     auto pItem = item<ObjectResourceItem>();
@@ -169,6 +277,10 @@ void ObjectEditor::save()
     pItem->setSprite(m_sprite);
     pItem->setMaskSprite(m_maskSprite);
 
+    // the files of the previous save must be written before these ones,
+    // and before their directory is renamed
+    finishSave();
+
     // Rename directory/file when name changes
     if (oldName != name)
     {
@@ -176,14 +288,21 @@ void ObjectEditor::save()
         QFile(GameSettings::rootPath() + "/objects/" + name + "/" + oldName + ".yy").rename(name + ".yy");
     }
 
-    // EVENTS (TODO: improve?)
+    QVector<QPair<QString, QByteArray>> files;
+    QVector<QPair<QString, QByteArray>> versions;
+    QMap<ObjectEvent*, QByteArray> savedEvents;
+
+    // EVENTS, only the modified ones
     for (int i = 0; i < ui->stackedCodeEditorWidget->count(); i++)
     {
         auto editor = qobject_cast<CodeEditor*>(ui->stackedCodeEditorWidget->widget(i));
-        if (editor)
+        if (editor && eventsModel.isModified(i))
         {
             QString filename = QString("%1/%2").arg(GameSettings::rootPath(), eventsModel.getFilename(i));
-            Utils::writeFile(filename, editor->getCode().toLocal8Bit());
+            auto data = editor->getCode().toLocal8Bit();
+            files.push_back({ filename, data });
+            versions.push_back({ eventsModel.getFilename(i), data });
+            savedEvents.insert(eventsModel.event(i), data);
         }
     }
 
@@ -223,14 +342,90 @@ void ObjectEditor::save()
     pItem->startAwake(ui->startAwakeCheckBox->isChecked());
     pItem->setKinematic(ui->kinematicCheckBox->isChecked());
 
-    // SAVE FILE
-    auto json = pItem->save();
-    QString filename = QString("%1/%2").arg(GameSettings::rootPath(), pItem->filename());
-    Utils::writeFile(filename, json);
+    // SAVE FILE, only if the object itself changed
+    if (m_objectChanged)
+    {
+        auto json = pItem->save();
+        QString filename = QString("%1/%2").arg(GameSettings::rootPath(), pItem->filename());
+        files.push_back({ filename, QJsonDocument(json).toJson() });
+    }
+
+    if (files.isEmpty())
+    {
+        emit saved();
+        setDirty(false);
+        return;
+    }
+
+    m_pendingWrites = Utils::writeFilesAsync(files);
+
+    m_saving = true;
+    m_savedObjectEdits = m_objectEdits;
+    m_savedEvents = savedEvents;
+    m_savedVersions = versions;
+    m_journaledWhileSaving.clear();
+
+    // the object is saved once its files are written
+    auto watcher = new QFutureWatcher<bool>(this);
+    connect(watcher, &QFutureWatcher<bool>::finished, this, [this, watcher]() {
+        watcher->deleteLater();
+        finishSave();
+    });
+    watcher->setFuture(m_pendingWrites);
+}
+
+void ObjectEditor::finishSave()
+{
+    // already done when the next save started
+    if (!m_saving)
+        return;
+
+    m_pendingWrites.waitForFinished();
+    m_saving = false;
+
+    if (!m_pendingWrites.result())
+    {
+        // nothing is clean, and the journal still has every edit
+        m_journaledWhileSaving.clear();
+        m_savedVersions.clear();
+        QMessageBox::warning(this, "Save object", QString("The files of %1 couldn't all be written.").arg(item<ObjectResourceItem>()->name()));
+        return;
+    }
+
+    // the history only keeps what is on the disk, and is only
+    // written from this thread, like the one of the scripts
+    for (auto & version : m_savedVersions)
+    {
+        LocalHistory::record(version.first, version.second);
+    }
+    m_savedVersions.clear();
 
     emit saved();
 
-    setDirty(false);
+    // the journal restarts from the written files, with the edits done since
+    for (auto & entry : m_journaledWhileSaving)
+    {
+        emit journalEntry(entry);
+    }
+    m_journaledWhileSaving.clear();
+
+    // only what was written and not changed since is clean
+    if (m_objectEdits == m_savedObjectEdits)
+        m_objectChanged = false;
+
+    for (int i = 0; i < eventsModel.rowCount(); i++)
+    {
+        auto it = m_savedEvents.find(eventsModel.event(i));
+        auto editor = qobject_cast<CodeEditor*>(ui->stackedCodeEditorWidget->widget(i));
+        if (it != m_savedEvents.end() && editor && editor->getCode().toLocal8Bit() == it.value())
+        {
+            eventsModel.setModified(i, false);
+            editor->setDirty(false);
+        }
+    }
+    m_savedEvents.clear();
+
+    MainEditor::setDirty(m_objectChanged || eventsModel.hasModifiedEvents());
 }
 
 void ObjectEditor::reset()
@@ -301,7 +496,24 @@ void ObjectEditor::reset()
 
 void ObjectEditor::setDirty(bool dirty)
 {
-    if (isDirty() == dirty) return;
+    // the state of an event code editor changed
+    for (int i = 0; i < ui->stackedCodeEditorWidget->count(); i++)
+    {
+        auto widget = ui->stackedCodeEditorWidget->widget(i);
+        if (widget == sender())
+        {
+            eventsModel.setModified(i, dirty);
+
+            // an event back to its saved state doesn't make the object clean
+            MainEditor::setDirty(dirty || m_objectChanged || eventsModel.hasModifiedEvents());
+            return;
+        }
+    }
+
+    // the object properties or the events list changed
+    m_objectChanged = dirty;
+    if (dirty)
+        m_objectEdits++;
 
     if (dirty == false)
     {
@@ -315,17 +527,6 @@ void ObjectEditor::setDirty(bool dirty)
             }
         }
     }
-    else
-    {
-        for (int i = 0; i < ui->stackedCodeEditorWidget->count(); i++)
-        {
-            auto widget = ui->stackedCodeEditorWidget->widget(i);
-            if (widget == sender())
-            {
-                eventsModel.setModified(i, true);
-            }
-        }
-    }
 
     MainEditor::setDirty(dirty);
 }
@@ -340,9 +541,19 @@ void ObjectEditor::onEventsAdded(const QModelIndex & parent, int first, int last
 
         auto inherited = eventsModel.isInherited(i);
         if (!inherited)
+        {
             connect(editor, &CodeEditor::dirtyChanged, this, qOverload<bool>(&ObjectEditor::setDirty));
+
+            auto event = eventsModel.event(i);
+            connect(editor, &CodeEditor::edited, this, [this, event](QJsonObject operation) {
+                operation["event"] = event->id();
+                emit journalEntry(operation);
+            });
+        }
         else
+        {
             editor->setReadOnly(true);
+        }
 
         auto filename = QString("%1/%2").arg(GameSettings::rootPath(), eventsModel.getFilename(i));
         auto code = Utils::readFile(filename);
@@ -387,6 +598,7 @@ void ObjectEditor::chooseParent()
                 ui->parentLineEdit->setText({});
             }
             setDirty();
+            journalProperty("parent", m_parentObject ? m_parentObject->id() : Uuid::null());
         }
     }
 }
@@ -410,6 +622,7 @@ void ObjectEditor::chooseMask()
             ui->maskLineEdit->setText({});
         }
         setDirty();
+        journalProperty("mask", m_maskSprite ? m_maskSprite->id() : Uuid::null());
     }
 }
 
@@ -432,6 +645,7 @@ void ObjectEditor::chooseSprite()
             ui->spriteViewer->setIcon(QIcon());
         }
         setDirty();
+        journalProperty("sprite", m_sprite ? m_sprite->id() : Uuid::null());
     }
 }
 
@@ -456,6 +670,8 @@ void ObjectEditor::showEventsContextMenu(const QPoint & pos)
             act->setData(QVariant::fromValue(event));
             act = menu.addAction("Delete event", this, &ObjectEditor::deleteEvent);
             act->setData(QVariant::fromValue(event));
+            act = menu.addAction("Local history", this, &ObjectEditor::showEventHistory);
+            act->setData(QVariant::fromValue(event));
         }
     }
     menu.exec(ui->eventsListView->mapToGlobal(pos));
@@ -490,6 +706,27 @@ void ObjectEditor::deleteEvent()
     auto event = action->data().value<ObjectEvent*>();
 
     eventsModel.deleteEvent(event);
+    setDirty();
+}
+
+void ObjectEditor::showEventHistory()
+{
+    auto action = qobject_cast<QAction*>(sender());
+    auto event = action->data().value<ObjectEvent*>();
+
+    for (int i = 0; i < eventsModel.rowCount(); i++)
+    {
+        if (eventsModel.event(i) == event)
+        {
+            HistoryDialog history(eventsModel.getFilename(i));
+            if (history.exec())
+            {
+                auto editor = qobject_cast<CodeEditor*>(ui->stackedCodeEditorWidget->widget(i));
+                editor->replaceCode(history.code());
+            }
+            break;
+        }
+    }
 }
 
 void ObjectEditor::menuTriggered(QAction * action)
@@ -502,6 +739,25 @@ void ObjectEditor::menuTriggered(QAction * action)
     auto newEvent = new ObjectEvent(eventTypeAndNumber.type, eventTypeAndNumber.number);
     newEvent->setOwner(pItem->id());
     eventsModel.addEvent(newEvent);
+
+    // the file of a new event doesn't exist yet
+    for (int i = 0; i < eventsModel.rowCount(); i++)
+    {
+        if (eventsModel.event(i) == newEvent)
+        {
+            eventsModel.setModified(i, true);
+        }
+    }
+    setDirty();
+}
+
+void ObjectEditor::journalProperty(QString name, QJsonValue value)
+{
+    QJsonObject entry;
+    entry["op"] = "property";
+    entry["name"] = name;
+    entry["value"] = value;
+    emit journalEntry(entry);
 }
 
 void ObjectEditor::createEventsMenu()
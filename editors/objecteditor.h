@@ -24,6 +24,7 @@
 #include "models/eventsmodel.h"
 #include "widgets/formedit.h"
 #include <QMenu>
+#include <QFuture>
 
 class ObjectEditor : public MainEditor
 {
@@ -34,6 +35,7 @@ public:
     using MainEditor::setDirty;
 
     void refreshChildren();
+    void replay(const QJsonObject & entry) override;
 
 signals:
     void childrenChanged(ObjectResourceItem* item);
@@ -55,9 +57,14 @@ private slots:
     void overrideEvent();
     void changeEvent();
     void deleteEvent();
+    void showEventHistory();
     void menuTriggered(QAction * action);
 
 private:
+    void journalProperty(QString name, QJsonValue value);
+    // applies the result of the running save, once its files are written
+    void finishSave();
+
     static void createEventsMenu();
     static QMenu * getEventsMenu();
     static QMenu eventsMenu;
@@ -69,11 +76,24 @@ private:
     FormEdit * m_linearDamping;
     FormEdit * m_angularDamping;
     FormEdit * m_friction;
+    QMap<QString, QCheckBox*> m_journaledCheckBoxes;
+    QMap<QString, FormEdit*> m_journaledEdits;
 
     EventsModel eventsModel;
     ObjectResourceItem * m_parentObject = nullptr;
     SpriteResourceItem * m_sprite = nullptr;
     SpriteResourceItem * m_maskSprite = nullptr;
+    bool m_objectChanged = false;
+    // counts the changes of the object, to know if one happened during a save
+    int m_objectEdits = 0;
+
+    // the running save: what it writes, and the edits done since it started
+    QFuture<bool> m_pendingWrites;
+    bool m_saving = false;
+    int m_savedObjectEdits = 0;
+    QMap<ObjectEvent*, QByteArray> m_savedEvents;
+    QVector<QPair<QString, QByteArray>> m_savedVersions;
+    QVector<QJsonObject> m_journaledWhileSaving;
 
     enum class MenuTriggeredType {
         Nothing,
@@ -0,0 +1,115 @@
+/*
+    Copyright (C) 2018  Alexander Roper
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "roomcommands.h"
+#include "roomeditor.h"
+
+MoveInstancesCommand::MoveInstancesCommand(RoomEditor * editor, QVector<ObjectInstance*> instances, QPointF offset, bool applied)
+    : m_editor { editor }
+    , m_instances { instances }
+    , m_offset { offset }
+    , m_applied { applied }
+{
+    setText(QString("Move %1 instance(s)").arg(m_instances.size()));
+}
+
+void MoveInstancesCommand::undo()
+{
+    m_editor->moveInstances(m_instances, -m_offset);
+}
+
+void MoveInstancesCommand::redo()
+{
+    // pushing the command calls redo
+    if (m_applied)
+    {
+        m_applied = false;
+        return;
+    }
+    m_editor->moveInstances(m_instances, m_offset);
+}
+
+AddInstancesCommand::AddInstancesCommand(RoomEditor * editor, QString layerId, QVector<ObjectInstance*> instances, QVector<int> indexes)
+    : m_editor { editor }
+    , m_layerId { layerId }
+    , m_instances { instances }
+    , m_indexes { indexes }
+{
+    setText(QString("Add %1 instance(s)").arg(m_instances.size()));
+}
+
+AddInstancesCommand::~AddInstancesCommand()
+{
+    if (m_removed)
+        m_editor->deleteInstances(m_instances);
+}
+
+void AddInstancesCommand::undo()
+{
+    remove();
+}
+
+void AddInstancesCommand::redo()
+{
+    add();
+}
+
+void AddInstancesCommand::add()
+{
+    m_editor->insertInstances(m_layerId, m_instances, m_indexes);
+    m_removed = false;
+}
+
+void AddInstancesCommand::remove()
+{
+    m_indexes = m_editor->removeInstances(m_layerId, m_instances);
+    m_removed = true;
+}
+
+RemoveInstancesCommand::RemoveInstancesCommand(RoomEditor * editor, QString layerId, QVector<ObjectInstance*> instances)
+    : AddInstancesCommand { editor, layerId, instances }
+{
+    setText(QString("Delete %1 instance(s)").arg(instances.size()));
+}
+
+void RemoveInstancesCommand::undo()
+{
+    add();
+}
+
+void RemoveInstancesCommand::redo()
+{
+    remove();
+}
+
+PropertyCommand::PropertyCommand(QString text, Setter setter, QVariant oldValue, QVariant newValue)
+    : m_setter { setter }
+    , m_oldValue { oldValue }
+    , m_newValue { newValue }
+{
+    setText(text);
+}
+
+void PropertyCommand::undo()
+{
+    m_setter(m_oldValue);
+}
+
+void PropertyCommand::redo()
+{
+    m_setter(m_newValue);
+}
@@ -0,0 +1,98 @@
+/*
+    Copyright (C) 2018  Alexander Roper
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef ROOMCOMMANDS_H
+#define ROOMCOMMANDS_H
+
+#include <QUndoCommand>
+#include <QPointF>
+#include <QVariant>
+#include <QVector>
+#include <functional>
+
+class RoomEditor;
+class ObjectInstance;
+
+// The instances all move by the same offset, so the command is a list
+// and one offset whatever the size of the selection
+class MoveInstancesCommand : public QUndoCommand
+{
+public:
+    // applied tells whether the instances were already moved (by dragging them)
+    MoveInstancesCommand(RoomEditor * editor, QVector<ObjectInstance*> instances, QPointF offset, bool applied);
+
+    void undo() override;
+    void redo() override;
+
+private:
+    RoomEditor * m_editor = nullptr;
+    QVector<ObjectInstance*> m_instances;
+    QPointF m_offset;
+    bool m_applied = false;
+};
+
+class AddInstancesCommand : public QUndoCommand
+{
+public:
+    // the instances are put at indexes in the layer, or after the others
+    AddInstancesCommand(RoomEditor * editor, QString layerId, QVector<ObjectInstance*> instances, QVector<int> indexes = {});
+    // the instances out of the room belong to the command
+    ~AddInstancesCommand() override;
+
+    void undo() override;
+    void redo() override;
+
+protected:
+    void add();
+    void remove();
+
+private:
+    RoomEditor * m_editor = nullptr;
+    QString m_layerId;
+    QVector<ObjectInstance*> m_instances;
+    // where the instances were in the layer
+    QVector<int> m_indexes;
+    bool m_removed = false;
+};
+
+class RemoveInstancesCommand : public AddInstancesCommand
+{
+public:
+    RemoveInstancesCommand(RoomEditor * editor, QString layerId, QVector<ObjectInstance*> instances);
+
+    void undo() override;
+    void redo() override;
+};
+
+// Any value of the room, set through the setter
+class PropertyCommand : public QUndoCommand
+{
+public:
+    using Setter = std::function<void(const QVariant &)>;
+
+    PropertyCommand(QString text, Setter setter, QVariant oldValue, QVariant newValue);
+
+    void undo() override;
+    void redo() override;
+
+private:
+    Setter m_setter;
+    QVariant m_oldValue;
+    QVariant m_newValue;
+};
+
+#endif // ROOMCOMMANDS_H
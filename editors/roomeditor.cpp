@@ -25,10 +25,63 @@
 #include "resources/dependencies/roomlayer.h"
 #include "resources/dependencies/backgroundlayer.h"
 #include "resources/dependencies/instancelayer.h"
+#include "resources/dependencies/tilelayer.h"
+#include "graphics/graphicstilechunk.h"
+#include "graphics/graphicsbackground.h"
 #include "graphics/graphicsinstance.h"
+#include "graphics/graphicsroomview.h"
+#include "graphics/spritecache.h"
+#include "graphics/roomrenderer.h"
+#include "resources/tilesetresourceitem.h"
 #include "resources/dependencies/objectinstance.h"
 #include "resources/objectresourceitem.h"
+#include "utils/jsonwriter.h"
+#include "roomcommands.h"
+#include "widgets/instancesearch.h"
+#include "widgets/roomanalysisdialog.h"
+#include "widgets/camerapreview.h"
+#include "resources/dependencies/roomview.h"
+#include <QAction>
+#include <QFileDialog>
+#include <QInputDialog>
+#include <QMessageBox>
+#include <QProgressDialog>
+#include <QSaveFile>
+#include <QElapsedTimer>
+#include <QFutureWatcher>
+#include <QtConcurrent>
+#include <QSignalBlocker>
 #include <QMenu>
+#include <QListWidget>
+#include <QLabel>
+#include <QPushButton>
+#include <QVBoxLayout>
+
+// in milliseconds, the time given to each slice of the loading
+static const int LOAD_SLICE = 8;
+// in milliseconds, the edits are gathered before the cameras are placed again
+static const int CAMERA_DELAY = 100;
+
+static QJsonArray instanceIds(const QVector<ObjectInstance*> & instances)
+{
+    QJsonArray ids;
+    for (auto & instance : instances)
+    {
+        ids.append(instance->id());
+    }
+    return ids;
+}
+
+static QVector<ObjectInstance*> findInstances(const QJsonArray & ids)
+{
+    QVector<ObjectInstance*> instances;
+    for (const auto & value : ids)
+    {
+        if (auto pInstance = ResourceItem::get<ObjectInstance>(value.toString()))
+            instances.append(pInstance);
+    }
+    return instances;
+}
 
 RoomEditor::RoomEditor(RoomResourceItem* item)
     : MainEditor { item }
@@ -42,30 +95,385 @@ RoomEditor::RoomEditor(RoomResourceItem* item)
 
     ui->layersListView->setModel(&layersModel);
     ui->objectsListView->setModel(&objectsModel);
+    // layers can hold tens of thousands of instances
+    ui->objectsListView->setUniformItemSizes(true);
+    ui->objectsListView->setLayoutMode(QListView::Batched);
     ui->roomView->setScene(&scene);
 
+    m_search = new InstanceSearch;
+    ui->toolBox->insertItem(1, m_search, "Search");
+    connect(m_search, &InstanceSearch::searchRequested, this, &RoomEditor::searchInstances);
+    connect(m_search, &InstanceSearch::resultActivated, this, &RoomEditor::showSearchResult);
+    connect(m_search, &InstanceSearch::selectResultsRequested, this, &RoomEditor::selectSearchResults);
+
+    // the views of the room, checked ones are outlined in the room,
+    // the current one is previewed
+    m_viewsLabel = new QLabel;
+    m_viewsLabel->setWordWrap(true);
+    m_viewsList = new QListWidget;
+    m_cameraPreview = new CameraPreview;
+    m_cameraPreview->setView(ui->roomView);
+    auto frameButton = new QPushButton("Show in the room");
+    auto viewsLayout = new QVBoxLayout(ui->scrollAreaWidgetContents_2);
+    viewsLayout->addWidget(m_viewsLabel);
+    viewsLayout->addWidget(m_viewsList, 1);
+    viewsLayout->addWidget(m_cameraPreview, 1);
+    viewsLayout->addWidget(frameButton);
+    connect(m_viewsList, &QListWidget::itemChanged, this, &RoomEditor::updateCameras);
+    connect(m_viewsList, &QListWidget::currentRowChanged, this, &RoomEditor::updateCameras);
+    connect(m_viewsList, &QListWidget::itemDoubleClicked, this, &RoomEditor::frameCamera);
+    connect(frameButton, &QPushButton::clicked, this, &RoomEditor::frameCamera);
+
     connect(&layersModel, &LayersModel::visibilityChanged, this, &RoomEditor::setLayerVisibility);
     connect(&objectsModel, &ObjectsModel::visibilityChanged, this, &RoomEditor::setInstanceVisibility);
     connect(ui->layersListView, &QListView::pressed, this, &RoomEditor::updateObjectsList);
     connect(ui->objectsListView, &QListView::pressed, this, &RoomEditor::updateSelectedItem);
     connect(ui->objectsListView, &QListView::customContextMenuRequested, this, &RoomEditor::showObjectsListContextMenu);
     connect(&scene, &QGraphicsScene::selectionChanged, this, &RoomEditor::selectedItemChanged);
+    connect(ui->roomView, &GraphicsRoomView::areaSelected, this, &RoomEditor::selectArea);
 
     scene.setBackgroundBrush(Qt::gray);
 
+    m_loadTimer.setInterval(0);
+    connect(&m_loadTimer, &QTimer::timeout, this, &RoomEditor::loadBatch);
+
+    m_cameraTimer.setSingleShot(true);
+    m_cameraTimer.setInterval(CAMERA_DELAY);
+    connect(&m_cameraTimer, &QTimer::timeout, this, &RoomEditor::updateCameras);
+
+    connect(&undoStack, &QUndoStack::cleanChanged, this, [this](bool clean) {
+        setDirty(!clean);
+    });
+    // each command adds, removes or moves instances
+    connect(&undoStack, &QUndoStack::indexChanged, this, [this]() {
+        item<RoomResourceItem>()->invalidateInstanceIndex();
+        // the cameras may follow an instance, they are placed again
+        // once after a series of commands
+        if (!m_loading && !m_cameraTimer.isActive())
+            m_cameraTimer.start();
+    });
+
+    auto undoAction = undoStack.createUndoAction(this);
+    undoAction->setShortcut(QKeySequence::Undo);
+    auto redoAction = undoStack.createRedoAction(this);
+    redoAction->setShortcut(QKeySequence::Redo);
+    auto deleteAction = new QAction("Delete", this);
+    deleteAction->setShortcut(QKeySequence::Delete);
+    connect(deleteAction, &QAction::triggered, this, &RoomEditor::deleteSelection);
+    auto duplicateAction = new QAction("Duplicate", this);
+    duplicateAction->setShortcut(Qt::CTRL + Qt::Key_D);
+    connect(duplicateAction, &QAction::triggered, this, &RoomEditor::duplicateSelection);
+    for (auto & action : { undoAction, redoAction, deleteAction, duplicateAction })
+    {
+        action->setShortcutContext(Qt::WidgetWithChildrenShortcut);
+        addAction(action);
+    }
+
+    // selection tools, only when the room has the focus
+    auto selectAllAction = new QAction("Select all", this);
+    selectAllAction->setShortcut(QKeySequence::SelectAll);
+    connect(selectAllAction, &QAction::triggered, this, &RoomEditor::selectAll);
+    auto invertAction = new QAction("Invert selection", this);
+    invertAction->setShortcut(Qt::CTRL + Qt::Key_I);
+    connect(invertAction, &QAction::triggered, this, &RoomEditor::invertSelection);
+    auto gridAction = new QAction("Show grid", this);
+    gridAction->setCheckable(true);
+    gridAction->setChecked(GameSettings::roomGridVisible());
+    gridAction->setShortcut(Qt::CTRL + Qt::Key_G);
+    // the settings are shared by the rooms, the state of the action
+    // may be the one of another room
+    connect(gridAction, &QAction::triggered, this, [this, gridAction]() {
+        bool visible = !GameSettings::roomGridVisible();
+        GameSettings::setRoomGridVisible(visible);
+        gridAction->setChecked(visible);
+        ui->roomView->viewport()->update();
+    });
+    auto snapAction = new QAction("Snap to grid", this);
+    snapAction->setCheckable(true);
+    snapAction->setChecked(GameSettings::roomSnapToGrid());
+    snapAction->setShortcut(Qt::CTRL + Qt::SHIFT + Qt::Key_G);
+    connect(snapAction, &QAction::triggered, this, [snapAction]() {
+        bool snap = !GameSettings::roomSnapToGrid();
+        GameSettings::setRoomSnapToGrid(snap);
+        snapAction->setChecked(snap);
+    });
+    auto gridSizeAction = new QAction("Grid size...", this);
+    connect(gridSizeAction, &QAction::triggered, this, [this]() {
+        bool ok = false;
+        int size = QInputDialog::getInt(this, "Grid size", "Size of the grid, in pixels:", GameSettings::roomGridSize(), 1, 4096, 1, &ok);
+        if (ok)
+        {
+            GameSettings::setRoomGridSize(size);
+            ui->roomView->viewport()->update();
+        }
+    });
+    auto exportAction = new QAction("Export as PNG...", this);
+    exportAction->setShortcut(Qt::CTRL + Qt::Key_E);
+    connect(exportAction, &QAction::triggered, this, &RoomEditor::exportImage);
+    auto analyzeAction = new QAction("Analyze performance...", this);
+    connect(analyzeAction, &QAction::triggered, this, &RoomEditor::analyzeRoom);
+    QList<QAction*> roomActions { selectAllAction, invertAction, gridAction, snapAction, exportAction };
+    const QList<QPair<int, QPointF>> nudges {
+        { Qt::Key_Left, { -1, 0 } }, { Qt::Key_Right, { 1, 0 } },
+        { Qt::Key_Up, { 0, -1 } }, { Qt::Key_Down, { 0, 1 } },
+    };
+    for (auto & nudge : nudges)
+    {
+        auto offset = nudge.second;
+        for (int modifier : { 0, int(Qt::SHIFT) })
+        {
+            auto action = new QAction(this);
+            action->setShortcut(nudge.first + modifier);
+            connect(action, &QAction::triggered, this, [this, offset, modifier]() {
+                nudgeSelection(modifier ? offset * 16 : offset);
+            });
+            roomActions.append(action);
+        }
+    }
+    for (auto & action : roomActions)
+    {
+        action->setShortcutContext(Qt::WidgetShortcut);
+        ui->roomView->addAction(action);
+    }
+
+    connect(ui->roomView, &GraphicsRoomView::roomMenuRequested, this, [=](const QPoint & pos) {
+        // the settings may have been changed in another room
+        gridAction->setChecked(GameSettings::roomGridVisible());
+        snapAction->setChecked(GameSettings::roomSnapToGrid());
+
+        QMenu menu;
+        menu.addAction(selectAllAction);
+        menu.addAction(invertAction);
+        menu.addSeparator();
+        menu.addAction(gridAction);
+        menu.addAction(snapAction);
+        menu.addAction(gridSizeAction);
+        menu.addSeparator();
+        menu.addAction(exportAction);
+        menu.addAction(analyzeAction);
+        menu.exec(pos);
+    });
+
     reset();
 }
 
 RoomEditor::~RoomEditor()
 {
+    // the commands delete the instances they removed, and their items
+    undoStack.clear();
+    qDeleteAll(m_removedItems);
     delete ui;
 }
 
+GraphicsRoomView * RoomEditor::roomView() const
+{
+    return ui->roomView;
+}
+
+void RoomEditor::replay(const QJsonObject & entry)
+{
+    // the instances must be in the scene
+    if (m_loading)
+    {
+        m_pendingReplays.append(entry);
+        return;
+    }
+
+    // journaled again by the commands, the previous journal is gone
+    auto op = entry["op"].toString();
+    if (op == "move")
+    {
+        QPointF offset(entry["dx"].toDouble(), entry["dy"].toDouble());
+        auto instances = findInstances(entry["instances"].toArray());
+        undoStack.push(new MoveInstancesCommand(this, instances, offset, false));
+    }
+    else if (op == "remove")
+    {
+        auto instances = findInstances(entry["instances"].toArray());
+        if (!instances.isEmpty())
+            undoStack.push(new RemoveInstancesCommand(this, entry["layer"].toString(), instances));
+    }
+    else if (op == "add")
+    {
+        // the instances may not be in the file, they are created again
+        QVector<ObjectInstance*> instances;
+        for (const auto & value : entry["instances"].toArray())
+        {
+            auto instance = new ObjectInstance;
+            instance->load(value.toObject());
+            instances.append(instance);
+        }
+        QVector<int> indexes;
+        for (const auto & value : entry["indexes"].toArray())
+        {
+            indexes.append(value.toInt());
+        }
+        undoStack.push(new AddInstancesCommand(this, entry["layer"].toString(), instances, indexes));
+    }
+    else if (op == "layerVisibility")
+    {
+        setLayerVisibility(entry["id"].toString(), entry["visible"].toBool());
+    }
+    else if (op == "instanceVisibility")
+    {
+        setInstanceVisibility(entry["id"].toString(), entry["visible"].toBool());
+    }
+}
+
+void RoomEditor::discardChanges()
+{
+    if (!isDirty())
+        return;
+
+    // nothing must use the instances of the room when it's read again
+    clearRoom();
+    item<RoomResourceItem>()->reload();
+}
+
+void RoomEditor::moveInstances(const QVector<ObjectInstance*> & instances, QPointF offset)
+{
+    // the instances of a move are on the same layer, and the view
+    // is updated once for all of them
+    auto gLayer = instances.isEmpty() ? nullptr : graphicsLayer(instances.first());
+    ui->roomView->beginBatch();
+    for (auto & instance : instances)
+    {
+        auto instItem = gLayer ? gLayer->item(instance) : nullptr;
+        if (instItem == nullptr)
+            instItem = graphicsInstance(instance);
+        if (instItem)
+        {
+            instItem->moveBy(offset.x(), offset.y());
+            trackPosition(instance, instItem);
+        }
+    }
+    ui->roomView->endBatch();
+
+    journalMove(instances, offset);
+}
+
+void RoomEditor::insertInstances(const QString & layerId, const QVector<ObjectInstance*> & instances, const QVector<int> & indexes)
+{
+    auto instLayer = ResourceItem::get<InstanceLayer>(layerId);
+    auto gLayer = graphicsLayers.value(layerId);
+    if (instLayer == nullptr || gLayer == nullptr)
+        return;
+
+    instLayer->insertInstances(instances, indexes);
+    for (auto & instance : instances)
+    {
+        auto instItem = m_removedItems.take(instance);
+        if (instItem == nullptr)
+        {
+            instItem = createGraphicsInstance(instance);
+            gLayer->addInstance(instItem);
+            instItem->updateSprite();
+        }
+        else
+        {
+            gLayer->addInstance(instItem);
+        }
+    }
+
+    if (gLayer == m_currentLayer)
+        fillObjectsList();
+
+    journalInsert(layerId, instances, indexes);
+}
+
+QVector<int> RoomEditor::removeInstances(const QString & layerId, const QVector<ObjectInstance*> & instances)
+{
+    auto instLayer = ResourceItem::get<InstanceLayer>(layerId);
+    auto gLayer = graphicsLayers.value(layerId);
+    if (instLayer == nullptr || gLayer == nullptr)
+        return {};
+
+    auto indexes = instLayer->removeInstances(instances);
+    for (auto & instance : instances)
+    {
+        if (auto instItem = gLayer->removeInstance(instance))
+            m_removedItems.insert(instance, instItem);
+    }
+
+    if (gLayer == m_currentLayer)
+        fillObjectsList();
+
+    journalRemove(layerId, instances);
+    return indexes;
+}
+
+void RoomEditor::deleteInstances(const QVector<ObjectInstance*> & instances)
+{
+    for (auto & instance : instances)
+    {
+        delete m_removedItems.take(instance);
+        m_movedPositions.remove(instance);
+        ResourceItem::unregisterItem(instance->id(), instance);
+        delete instance;
+    }
+}
+
+void RoomEditor::setLayerVisible(const QString & id, bool visible)
+{
+    if (auto gLayer = graphicsLayers.value(id))
+    {
+        gLayer->setVisible(visible);
+        layersModel.setLayerVisible(id, visible);
+        journalVisibility("layerVisibility", id, visible);
+    }
+}
+
+void RoomEditor::setInstanceVisible(ObjectInstance * instance, bool visible)
+{
+    if (auto gLayer = graphicsLayer(instance))
+    {
+        gLayer->setElementVisible(instance, visible);
+        objectsModel.setInstanceVisible(instance, visible);
+        journalVisibility("instanceVisibility", instance->id(), visible);
+    }
+}
+
+void RoomEditor::showInstance(ObjectInstance * instance)
+{
+    // the instance must be in the scene
+    if (m_loading)
+    {
+        m_pendingInstance = instance;
+        return;
+    }
+
+    auto gLayer = graphicsLayer(instance);
+    if (gLayer == nullptr)
+        return;
+
+    if (gLayer != m_currentLayer)
+        setCurrentLayer(graphicsLayers.key(gLayer));
+
+    auto instItem = gLayer->item(instance);
+    setSelection({ instItem });
+    ui->roomView->centerOn(instItem);
+}
+
 void RoomEditor::save()
 {
     auto pItem = item<RoomResourceItem>();
-    pItem->save();
+    commitPositions();
+    m_movedPositions.clear();
 
+    QString filename = QString("%1/%2").arg(GameSettings::rootPath(), pItem->filename());
+    bool ok = Utils::writeFile(filename, [pItem](QIODevice * device) {
+        JsonWriter writer(device);
+        pItem->write(writer);
+        return !writer.hasError();
+    });
+    if (!ok)
+    {
+        return;
+    }
+
+    emit saved();
+
+    undoStack.setClean();
     setDirty(false);
 }
 
@@ -73,34 +481,59 @@ void RoomEditor::reset()
 {
     auto pItem = item<RoomResourceItem>();
 
-    scene.clear();
-    auto bg = scene.addRect(0, 0, pItem->width() - 1, pItem->height() - 1, QPen(QColor(0, 0, 0)), QBrush(Qt::white));
-    bg->setZValue(-999999);
+    // the commands changed the room itself, it's read again from its
+    // file once nothing uses its instances (clearing the commands makes
+    // the editor clean)
+    bool changed = isDirty();
+    clearRoom();
+    if (changed)
+        pItem->reload();
 
-    for (auto & layer : pItem->layers())
+    fillViews();
+
+    QRectF roomRect(0, 0, pItem->width(), pItem->height());
+    auto layers = pItem->layers();
+    for (int i = 0; i < layers.size(); i++)
     {
+        auto layer = layers[i];
         layersModel.addLayer(layer);
 
+        // every kind of layer is drawn at its depth
         GraphicsLayer * gLayer = new GraphicsLayer;
+        gLayer->setDepth(layer->depth(), i);
         graphicsLayers[layer->id()] = gLayer;
         scene.addItem(gLayer);
 
         if (layer->type() == RoomLayer::Type::Background)
         {
-            auto depth = layer->depth();
-            gLayer->setZValue(-depth);
-
             auto bgLayer = qobject_cast<BackgroundLayer*>(layer);
             if (auto sprite = bgLayer->sprite())
             {
-                QPixmap pix = sprite->pixmap();
-                auto pixItem = scene.addPixmap(pix);
-                pixItem->setParentItem(gLayer);
+                whenSpriteReady(sprite, [bgLayer, gLayer, roomRect]() {
+                    auto bgItem = new GraphicsBackground(bgLayer, roomRect.size());
+                    gLayer->addItem(bgItem);
+                });
             }
             else
             {
-                auto bgColor = scene.addRect(0, 0, pItem->width(), pItem->height(), QPen(), QBrush(bgLayer->colour()));
-                bgColor->setParentItem(gLayer);
+                auto bgColor = scene.addRect(roomRect, QPen(), QBrush(bgLayer->colour()));
+                gLayer->addItem(bgColor);
+            }
+        }
+        else if (layer->type() == RoomLayer::Type::Tiles)
+        {
+            // one item per chunk of tiles, drawn in one go
+            auto tileLayer = qobject_cast<TileLayer*>(layer);
+            auto tileSet = tileLayer->tileSet();
+            if (tileSet && tileSet->sprite())
+            {
+                whenSpriteReady(tileSet->sprite(), [tileLayer, gLayer]() {
+                    for (auto & chunk : tileLayer->chunks())
+                    {
+                        auto chunkItem = new GraphicsTileChunk(tileLayer, chunk);
+                        gLayer->addItem(chunkItem);
+                    }
+                });
             }
         }
         else if (layer->type() == RoomLayer::Type::Instances)
@@ -108,24 +541,160 @@ void RoomEditor::reset()
             auto instLayer = qobject_cast<InstanceLayer*>(layer);
             for (auto & instance : instLayer->instances())
             {
-                auto instItem = new GraphicsInstance(instance);
-                instItem->setParentItem(gLayer);
-                connect(instItem, &GraphicsInstance::openObject, this, &RoomEditor::openObject);
-                connect(instItem, &GraphicsInstance::openInstance, this, &RoomEditor::openInstance);
+                m_loadQueue.append({ gLayer, instance });
             }
             gLayer->setCurrent(false);
-            //so the instances are always visible
-            gLayer->setZValue(1000);
+            gLayer->setFaded(true);
         }
     }
+
+    // the room itself is drawn by the view
+    ui->roomView->setRoomSize(roomRect.size().toSize());
+    scene.setSceneRect(roomRect);
+
+    // the instances are added by loadBatch, the editor can't be used until then
+    m_loading = true;
+    ui->toolBox->setEnabled(false);
+    m_loadTimer.start();
 }
 
-void RoomEditor::setLayerVisibility(QString id, bool visible)
+void RoomEditor::clearRoom()
 {
-    graphicsLayers[id]->setVisible(visible);
-    ui->layersListView->update();
+    // the view keeps pointers to the layers
+    ui->roomView->setLayers({});
+    undoStack.clear();
+    qDeleteAll(m_removedItems);
+    m_removedItems.clear();
+    m_movedPositions.clear();
+    m_currentLayer = nullptr;
+    m_currentLayerId.clear();
+    graphicsLayers.clear();
+    layersModel.clear();
+    objectsModel.clear();
+    scene.clear();
+
+    // a previous loading is abandoned
+    m_loadTimer.stop();
+    m_loadQueue.clear();
+    m_loadPosition = 0;
+    m_loadGeneration++;
+    m_requestedSprites.clear();
+    m_waitingInstances.clear();
+    m_spriteCallbacks.clear();
+    m_pendingInstance = nullptr;
+    m_search->setResults({}, false);
+    ui->roomView->setHeatmap(QImage(), 0);
+}
+
+void RoomEditor::loadBatch()
+{
+    QElapsedTimer timer;
+    timer.start();
+    while (m_loadPosition < m_loadQueue.size() && timer.elapsed() < LOAD_SLICE)
+    {
+        auto & next = m_loadQueue[m_loadPosition++];
+        auto instItem = createGraphicsInstance(next.second);
+        next.first->addInstance(instItem);
 
-    setDirty();
+        if (!instItem->hasSprite() && instItem->sprite())
+        {
+            m_waitingInstances[instItem->sprite()].append(instItem);
+            requestSprite(instItem->sprite());
+        }
+    }
+
+    if (m_loadPosition >= m_loadQueue.size())
+    {
+        finishLoading();
+    }
+}
+
+void RoomEditor::finishLoading()
+{
+    m_loadTimer.stop();
+    m_loadQueue.clear();
+    m_loadPosition = 0;
+
+    auto pItem = item<RoomResourceItem>();
+    QRectF roomRect(0, 0, pItem->width(), pItem->height());
+    scene.setSceneRect(scene.itemsBoundingRect() | roomRect);
+    ui->roomView->setLayers(graphicsLayers.values());
+
+    m_loading = false;
+    ui->toolBox->setEnabled(true);
+    updateCameras();
+
+    auto replays = m_pendingReplays;
+    m_pendingReplays.clear();
+    for (auto & entry : replays)
+    {
+        replay(entry);
+    }
+
+    if (m_pendingInstance)
+    {
+        showInstance(m_pendingInstance);
+        m_pendingInstance = nullptr;
+    }
+}
+
+void RoomEditor::whenSpriteReady(SpriteResourceItem * sprite, std::function<void()> callback)
+{
+    QPixmap pix;
+    if (SpriteCache::find(sprite, 0, &pix))
+    {
+        callback();
+        return;
+    }
+
+    m_spriteCallbacks[sprite].append(callback);
+    requestSprite(sprite);
+}
+
+void RoomEditor::requestSprite(SpriteResourceItem * sprite)
+{
+    if (m_requestedSprites.contains(sprite))
+        return;
+    m_requestedSprites.insert(sprite);
+
+    // only the path is given to the thread, the resources stay in this one
+    QString path = sprite->framePath(0);
+    int generation = m_loadGeneration;
+    auto watcher = new QFutureWatcher<QImage>(this);
+    connect(watcher, &QFutureWatcher<QImage>::finished, this, [this, watcher, sprite, generation]() {
+        watcher->deleteLater();
+        // converted in this thread, QPixmap can't be used in the others
+        SpriteCache::insert(sprite, 0, QPixmap::fromImage(watcher->result()));
+        if (generation == m_loadGeneration)
+        {
+            spriteReady(sprite);
+        }
+    });
+    watcher->setFuture(QtConcurrent::run([path]() {
+        return QImage(path);
+    }));
+}
+
+void RoomEditor::spriteReady(SpriteResourceItem * sprite)
+{
+    // the cached tiles are invalidated once for all the instances
+    ui->roomView->beginBatch();
+    for (auto & instItem : m_waitingInstances.take(sprite))
+    {
+        instItem->updateSprite();
+    }
+    for (auto & callback : m_spriteCallbacks.take(sprite))
+    {
+        callback();
+    }
+    ui->roomView->endBatch();
+}
+
+void RoomEditor::setLayerVisibility(QString id, bool visible)
+{
+    undoStack.push(new PropertyCommand(visible ? "Show layer" : "Hide layer", [this, id](const QVariant & value) {
+        setLayerVisible(id, value.toBool());
+    }, !visible, visible));
 }
 
 void RoomEditor::updateObjectsList(const QModelIndex & index)
@@ -139,29 +708,345 @@ void RoomEditor::updateObjectsList(const QModelIndex & index)
     {
         m_currentLayer->setCurrent(false);
         m_currentLayer = nullptr;
+        m_currentLayerId.clear();
     }
 
-    objectsModel.clear();
-
     auto pLayer = layersModel.layer(index.row());
     if (pLayer->type() == RoomLayer::Type::Instances)
     {
-        auto pInstLayer = qobject_cast<InstanceLayer*>(pLayer);
-        m_currentLayer = graphicsLayers[pInstLayer->id()];
+        m_currentLayerId = pLayer->id();
+        m_currentLayer = graphicsLayers[m_currentLayerId];
         m_currentLayer->setCurrent(true);
+    }
+    fillObjectsList();
+
+    ui->roomView->setActiveLayer(m_currentLayer);
+}
+
+void RoomEditor::exportImage()
+{
+    if (m_loading)
+        return;
+
+    auto pItem = item<RoomResourceItem>();
+    QString filename = QFileDialog::getSaveFileName(this, "Export room", pItem->name() + ".png", "PNG image (*.png)");
+    if (filename.isEmpty())
+        return;
+
+    bool ok = false;
+    qreal scale = QInputDialog::getDouble(this, "Export room", "Scale:", 1, 0.01, 16, 2, &ok);
+    if (!ok)
+        return;
+
+    // the renderer draws the instances, where they are in the view
+    RoomRenderer renderer(pItem, m_movedPositions);
+
+    QSaveFile file(filename);
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        QMessageBox::warning(this, "Export room", QString("Can't open %1: %2").arg(filename, file.errorString()));
+        return;
+    }
+
+    QProgressDialog progressDialog("Exporting the room...", "Cancel", 0, 100, this);
+    progressDialog.setWindowModality(Qt::WindowModal);
+    ok = renderer.exportPng(&file, scale, [&progressDialog](int done, int total) {
+        progressDialog.setValue(done * 100 / total);
+        return !progressDialog.wasCanceled();
+    });
+
+    if (!ok)
+    {
+        file.cancelWriting();
+        if (!progressDialog.wasCanceled())
+            QMessageBox::warning(this, "Export room", QString("The room couldn't be exported to %1.").arg(filename));
+        return;
+    }
+    file.commit();
+}
+
+void RoomEditor::searchInstances()
+{
+    if (m_loading)
+        return;
+
+    auto pItem = item<RoomResourceItem>();
+    auto query = m_search->query();
+    if (m_search->visibleAreaOnly())
+    {
+        auto viewRect = ui->roomView->mapToScene(ui->roomView->viewport()->rect()).boundingRect();
+        query.region = viewRect.toAlignedRect();
+    }
+
+    // the index is rebuilt from the instances after the commands,
+    // the ones moved in this room are found where they are in the view
+    QVector<SearchResult> results;
+    if (m_search->allRooms())
+    {
+        for (auto & roomId : ResourceItem::findAll(ResourceType::Room))
+        {
+            auto pRoom = ResourceItem::get<RoomResourceItem>(roomId);
+            // the other rooms are searched as they are saved
+            auto positions = pRoom == pItem ? m_movedPositions : QHash<ObjectInstance*, QPoint>();
+            for (auto & instance : pRoom->instanceIndex().find(query, positions))
+            {
+                results.append({ roomId, instance->id(), positions.value(instance, instance->position()) });
+            }
+        }
+    }
+    else
+    {
+        for (auto & instance : pItem->instanceIndex().find(query, m_movedPositions))
+        {
+            results.append({ pItem->id(), instance->id(), m_movedPositions.value(instance, instance->position()) });
+        }
+    }
+    m_search->setResults(results, m_search->allRooms());
+}
+
+void RoomEditor::showSearchResult(RoomResourceItem * room, ObjectInstance * instance)
+{
+    if (room == item<RoomResourceItem>())
+        showInstance(instance);
+    else
+        emit showRoomInstance(room, instance);
+}
+
+void RoomEditor::selectSearchResults()
+{
+    auto instances = m_search->results(item<RoomResourceItem>());
+    if (instances.isEmpty())
+        return;
+
+    // only one layer is edited at once, the one of the first result
+    auto gLayer = graphicsLayer(instances.first());
+    if (gLayer == nullptr)
+        return;
+    if (gLayer != m_currentLayer)
+        setCurrentLayer(graphicsLayers.key(gLayer));
+
+    QVector<GraphicsInstance*> items;
+    for (auto & instance : instances)
+    {
+        auto instItem = gLayer->item(instance);
+        if (instItem && instItem->isVisible())
+            items.append(instItem);
+    }
+    setSelection(items);
+}
+
+void RoomEditor::setCurrentLayer(const QString & layerId)
+{
+    for (int row = 0; row < layersModel.rowCount(); row++)
+    {
+        if (layersModel.layer(row)->id() == layerId)
+        {
+            auto index = layersModel.index(row);
+            ui->layersListView->setCurrentIndex(index);
+            updateObjectsList(index);
+            return;
+        }
+    }
+}
+
+void RoomEditor::analyzeRoom()
+{
+    if (m_loading || m_analyzing)
+        return;
+
+    // the analysis reads the instances, where they are in the view,
+    // and only gets a copy of them in its thread
+    auto snapshot = RoomAnalysis::snapshot(item<RoomResourceItem>(), m_movedPositions);
+
+    m_analyzing = true;
+    int generation = m_loadGeneration;
+    auto watcher = new QFutureWatcher<RoomAnalysis::Report>(this);
+    connect(watcher, &QFutureWatcher<RoomAnalysis::Report>::finished, this, [this, watcher, generation]() {
+        watcher->deleteLater();
+        m_analyzing = false;
+        if (generation == m_loadGeneration)
+        {
+            showAnalysis(watcher->result());
+        }
+    });
+    watcher->setFuture(QtConcurrent::run([snapshot]() {
+        return RoomAnalysis::analyze(snapshot);
+    }));
+}
+
+void RoomEditor::showAnalysis(const RoomAnalysis::Report & report)
+{
+    // the previous report would remove the new heatmap when closed
+    if (m_analysisDialog)
+        m_analysisDialog->close();
+
+    auto heatmap = report.heatmap;
+    int cellSize = report.cellSize;
+    ui->roomView->setHeatmap(heatmap, cellSize);
+
+    auto dialog = new RoomAnalysisDialog(report, this);
+    m_analysisDialog = dialog;
+    dialog->setAttribute(Qt::WA_DeleteOnClose);
+    connect(dialog, &RoomAnalysisDialog::heatmapToggled, this, [this, heatmap, cellSize](bool visible) {
+        ui->roomView->setHeatmap(visible ? heatmap : QImage(), cellSize);
+    });
+    connect(dialog, &QDialog::finished, this, [this]() {
+        ui->roomView->setHeatmap(QImage(), 0);
+    });
+    dialog->show();
+}
+
+void RoomEditor::fillViews()
+{
+    auto pItem = item<RoomResourceItem>();
+
+    QStringList notes;
+    if (!pItem->viewSettings().areViewsEnabled())
+        notes << "The views are not enabled in this room.";
+    auto & physics = pItem->physicsSettings();
+    if (physics.isPhysicsWorld())
+    {
+        notes << QString("Physics world: gravity %1, %2, %3 meters per pixel.")
+                 .arg(physics.gravity().x()).arg(physics.gravity().y()).arg(physics.pixelsToMeters());
+    }
+    m_viewsLabel->setText(notes.join("\n"));
+    m_viewsLabel->setVisible(!notes.isEmpty());
+
+    QSignalBlocker blocker(m_viewsList);
+    m_viewsList->clear();
+    auto views = pItem->views();
+    for (int i = 0; i < views.size(); i++)
+    {
+        auto view = views[i];
+        auto camera = view->camera();
+        auto text = QString("View %1: %2x%3").arg(i).arg(camera.width()).arg(camera.height());
+        if (auto object = view->followedObject())
+            text += QString(", follows %1").arg(object->name());
+
+        auto listItem = new QListWidgetItem(text, m_viewsList);
+        listItem->setFlags(listItem->flags() | Qt::ItemIsUserCheckable);
+        // the views used by the game are outlined at first
+        listItem->setCheckState(view->isVisible() ? Qt::Checked : Qt::Unchecked);
+    }
+    if (!views.isEmpty())
+        m_viewsList->setCurrentRow(0);
+
+    ui->roomView->setCameras({});
+    m_cameraPreview->setCamera(QRect());
+}
+
+QRect RoomEditor::cameraRect(RoomView * view)
+{
+    auto pItem = item<RoomResourceItem>();
+    auto camera = view->camera();
+
+    // the camera starts on the first instance it follows, inside the room
+    if (auto object = view->followedObject())
+    {
+        if (auto instItem = firstInstanceOf(object))
+        {
+            camera.moveCenter(instItem->pos().toPoint());
+            camera.moveLeft(qBound(0, camera.left(), qMax(0, pItem->width() - camera.width())));
+            camera.moveTop(qBound(0, camera.top(), qMax(0, pItem->height() - camera.height())));
+        }
+    }
+    return camera;
+}
+
+GraphicsInstance * RoomEditor::firstInstanceOf(ObjectResourceItem * object)
+{
+    // the instances are read in the order of the room, each with its own layer
+    auto objectId = object->id();
+    for (auto & layer : item<RoomResourceItem>()->layers())
+    {
+        auto instLayer = qobject_cast<InstanceLayer*>(layer);
+        auto gLayer = graphicsLayers.value(layer->id());
+        if (instLayer == nullptr || gLayer == nullptr)
+            continue;
+
+        for (auto & instance : instLayer->instances())
+        {
+            if (instance->objectId() == objectId)
+                return gLayer->item(instance);
+        }
+    }
+    return nullptr;
+}
+
+void RoomEditor::updateCameras()
+{
+    m_cameraTimer.stop();
+    if (m_loading)
+        return;
+
+    auto views = item<RoomResourceItem>()->views();
+    QVector<QRect> cameras;
+    for (int i = 0; i < views.size() && i < m_viewsList->count(); i++)
+    {
+        bool shown = m_viewsList->item(i)->checkState() == Qt::Checked;
+        cameras.append(shown ? cameraRect(views[i]) : QRect());
+    }
+
+    int current = m_viewsList->currentRow();
+    ui->roomView->setCameras(cameras, current);
+    m_cameraPreview->setCamera(current >= 0 && current < views.size() ? cameraRect(views[current]) : QRect());
+}
+
+void RoomEditor::frameCamera()
+{
+    auto views = item<RoomResourceItem>()->views();
+    int current = m_viewsList->currentRow();
+    if (m_loading || current < 0 || current >= views.size())
+        return;
 
-        for (auto & inst : pInstLayer->instances())
+    // the whole camera in the view, with a margin
+    auto camera = cameraRect(views[current]);
+    if (camera.isEmpty())
+        return;
+    auto viewport = ui->roomView->viewport()->size();
+    ui->roomView->setZoom(0.9 * qMin(qreal(viewport.width()) / camera.width(), qreal(viewport.height()) / camera.height()));
+    ui->roomView->centerOn(camera.center());
+}
+
+void RoomEditor::commitPositions()
+{
+    // instances may have been moved in the view
+    for (auto & layer : item<RoomResourceItem>()->layers())
+    {
+        if (layer->type() == RoomLayer::Type::Instances)
         {
-            objectsModel.addObject(inst);
-            auto idx = objectsModel.indexOf(inst);
-            auto checked = m_currentLayer->isElementVisible(inst);
-            auto blocked = objectsModel.blockSignals(true);
-            objectsModel.setData(idx, checked ? Qt::Checked : Qt::Unchecked, Qt::CheckStateRole);
-            objectsModel.blockSignals(blocked);
+            graphicsLayers[layer->id()]->commitPositions();
         }
     }
 }
 
+void RoomEditor::trackPosition(ObjectInstance * instance, GraphicsInstance * instItem)
+{
+    auto position = instItem->pos().toPoint();
+    if (position == instance->position())
+        m_movedPositions.remove(instance);
+    else
+        m_movedPositions.insert(instance, position);
+}
+
+void RoomEditor::fillObjectsList()
+{
+    auto pInstLayer = m_currentLayerId.isEmpty() ? nullptr : ResourceItem::get<InstanceLayer>(m_currentLayerId);
+    if (pInstLayer == nullptr || m_currentLayer == nullptr)
+    {
+        objectsModel.clear();
+        return;
+    }
+
+    auto instances = pInstLayer->instances();
+    QBitArray visible(instances.size());
+    for (int i = 0; i < instances.size(); i++)
+    {
+        visible.setBit(i, m_currentLayer->isElementVisible(instances[i]));
+    }
+    objectsModel.setInstances(instances, visible);
+}
+
 void RoomEditor::selectedItemChanged()
 {
     auto items = scene.selectedItems();
@@ -170,7 +1055,7 @@ void RoomEditor::selectedItemChanged()
 
     // if more than 1 items are present in the list, the first one is THE ONE we are interested in.
     auto item = items.first();
-    auto instanceItem = static_cast<GraphicsInstance*>(item);
+    auto instanceItem = qgraphicsitem_cast<GraphicsInstance*>(item);
     if (instanceItem)
     {
         auto modelIndex = objectsModel.indexOf(instanceItem->objectInstance());
@@ -191,9 +1076,267 @@ void RoomEditor::updateSelectedItem(const QModelIndex & index)
 void RoomEditor::setInstanceVisibility(QString id, bool visible)
 {
     auto pInstance = ResourceItem::get<ObjectInstance>(id);
-    m_currentLayer->setElementVisible(pInstance, visible);
+    undoStack.push(new PropertyCommand(visible ? "Show instance" : "Hide instance", [this, pInstance](const QVariant & value) {
+        setInstanceVisible(pInstance, value.toBool());
+    }, !visible, visible));
+}
 
-    setDirty();
+void RoomEditor::instancesMoved(QPointF offset)
+{
+    // the selection was moved by dragging it, one command for all of it
+    QVector<ObjectInstance*> instances;
+    for (auto & item : scene.selectedItems())
+    {
+        if (auto instItem = qgraphicsitem_cast<GraphicsInstance*>(item))
+        {
+            instances.append(instItem->objectInstance());
+            trackPosition(instItem->objectInstance(), instItem);
+        }
+    }
+    undoStack.push(new MoveInstancesCommand(this, instances, offset, true));
+
+    // the command only journals when it moves the instances itself
+    journalMove(instances, offset);
+}
+
+void RoomEditor::selectArea(const QRectF & rect, Qt::KeyboardModifiers modifiers)
+{
+    if (m_currentLayer == nullptr)
+        return;
+
+    bool add = modifiers & Qt::ControlModifier;
+    setSelection(rect.isEmpty() ? QVector<GraphicsInstance*>() : m_currentLayer->instancesIn(rect), add);
+}
+
+void RoomEditor::selectAll()
+{
+    auto pInstLayer = m_currentLayerId.isEmpty() ? nullptr : ResourceItem::get<InstanceLayer>(m_currentLayerId);
+    if (pInstLayer == nullptr)
+        return;
+
+    QVector<GraphicsInstance*> items;
+    for (auto & instance : pInstLayer->instances())
+    {
+        auto instItem = m_currentLayer->item(instance);
+        if (instItem && instItem->isVisible())
+            items.append(instItem);
+    }
+    setSelection(items);
+}
+
+void RoomEditor::selectObject(ObjectResourceItem * object)
+{
+    auto pInstLayer = m_currentLayerId.isEmpty() ? nullptr : ResourceItem::get<InstanceLayer>(m_currentLayerId);
+    if (pInstLayer == nullptr || object == nullptr)
+        return;
+
+    QVector<GraphicsInstance*> items;
+    for (auto & instance : pInstLayer->instances())
+    {
+        if (instance->object() != object)
+            continue;
+
+        auto instItem = m_currentLayer->item(instance);
+        if (instItem && instItem->isVisible())
+            items.append(instItem);
+    }
+    setSelection(items);
+}
+
+void RoomEditor::invertSelection()
+{
+    auto pInstLayer = m_currentLayerId.isEmpty() ? nullptr : ResourceItem::get<InstanceLayer>(m_currentLayerId);
+    if (pInstLayer == nullptr)
+        return;
+
+    QVector<GraphicsInstance*> items;
+    for (auto & instance : pInstLayer->instances())
+    {
+        auto instItem = m_currentLayer->item(instance);
+        if (instItem && instItem->isVisible() && !instItem->isSelected())
+            items.append(instItem);
+    }
+    setSelection(items);
+}
+
+void RoomEditor::nudgeSelection(QPointF offset)
+{
+    auto instances = selectedInstances();
+    if (instances.isEmpty())
+        return;
+
+    // the instances move from one cell of the grid to the next
+    if (GameSettings::roomSnapToGrid())
+        offset = QPointF(qBound(-1.0, offset.x(), 1.0), qBound(-1.0, offset.y(), 1.0)) * GameSettings::roomGridSize();
+
+    undoStack.push(new MoveInstancesCommand(this, instances, offset, false));
+}
+
+void RoomEditor::deleteSelection()
+{
+    auto instances = selectedInstances();
+    if (instances.isEmpty() || m_currentLayerId.isEmpty())
+        return;
+
+    undoStack.push(new RemoveInstancesCommand(this, m_currentLayerId, instances));
+}
+
+void RoomEditor::duplicateSelection()
+{
+    auto instances = selectedInstances();
+    if (instances.isEmpty() || m_currentLayerId.isEmpty())
+        return;
+
+    // the copies stay aligned on the grid
+    qreal shift = GameSettings::roomSnapToGrid() ? GameSettings::roomGridSize() : 16;
+
+    QVector<ObjectInstance*> copies;
+    for (auto & instance : instances)
+    {
+        auto json = instance->save();
+        auto id = Uuid::generate();
+        auto position = graphicsInstance(instance)->pos() + QPointF(shift, shift);
+        json["id"] = id;
+        json["name"] = QString("inst_%1").arg(id.left(8).toUpper());
+        json["x"] = qRound(position.x());
+        json["y"] = qRound(position.y());
+
+        auto copy = new ObjectInstance;
+        copy->load(json);
+        copies.append(copy);
+    }
+
+    undoStack.push(new AddInstancesCommand(this, m_currentLayerId, copies));
+
+    // the copies replace the selection
+    QVector<GraphicsInstance*> items;
+    for (auto & copy : copies)
+    {
+        if (auto instItem = graphicsInstance(copy))
+            items.append(instItem);
+    }
+    setSelection(items);
+}
+
+GraphicsInstance * RoomEditor::graphicsInstance(ObjectInstance * instance) const
+{
+    if (auto gLayer = graphicsLayer(instance))
+    {
+        return gLayer->item(instance);
+    }
+    return nullptr;
+}
+
+GraphicsLayer * RoomEditor::graphicsLayer(ObjectInstance * instance) const
+{
+    if (instance == nullptr)
+        return nullptr;
+
+    for (auto & gLayer : graphicsLayers)
+    {
+        if (gLayer->item(instance))
+        {
+            return gLayer;
+        }
+    }
+    return nullptr;
+}
+
+GraphicsInstance * RoomEditor::createGraphicsInstance(ObjectInstance * instance)
+{
+    auto instItem = new GraphicsInstance(instance);
+    connect(instItem, &GraphicsInstance::openObject, this, &RoomEditor::openObject);
+    connect(instItem, &GraphicsInstance::openInstance, this, &RoomEditor::openInstance);
+    connect(instItem, &GraphicsInstance::moved, this, &RoomEditor::instancesMoved);
+    connect(instItem, &GraphicsInstance::selectObject, this, &RoomEditor::selectObject);
+    return instItem;
+}
+
+void RoomEditor::setSelection(const QVector<GraphicsInstance*> & items, bool add)
+{
+    {
+        // the scene would signal each item
+        QSignalBlocker blocker(&scene);
+        if (!add)
+            scene.clearSelection();
+        for (auto & instItem : items)
+        {
+            instItem->setSelected(true);
+        }
+    }
+    selectedItemChanged();
+}
+
+void RoomEditor::journalMove(const QVector<ObjectInstance*> & instances, QPointF offset)
+{
+    // one entry for all the instances
+    QJsonObject entry;
+    entry["op"] = "move";
+    entry["instances"] = instanceIds(instances);
+    entry["dx"] = offset.x();
+    entry["dy"] = offset.y();
+    emit journalEntry(entry);
+}
+
+void RoomEditor::journalInsert(const QString & layerId, const QVector<ObjectInstance*> & instances, const QVector<int> & indexes)
+{
+    // the instances are journaled whole, the duplicates are not in the
+    // file, and where they are in the view
+    auto gLayer = graphicsLayers.value(layerId);
+    QJsonArray instancesJson;
+    for (auto & instance : instances)
+    {
+        auto json = instance->save();
+        if (auto instItem = gLayer ? gLayer->item(instance) : nullptr)
+        {
+            json["x"] = qRound(instItem->pos().x());
+            json["y"] = qRound(instItem->pos().y());
+        }
+        instancesJson.append(json);
+    }
+    QJsonArray indexesJson;
+    for (int index : indexes)
+    {
+        indexesJson.append(index);
+    }
+
+    QJsonObject entry;
+    entry["op"] = "add";
+    entry["layer"] = layerId;
+    entry["instances"] = instancesJson;
+    entry["indexes"] = indexesJson;
+    emit journalEntry(entry);
+}
+
+void RoomEditor::journalRemove(const QString & layerId, const QVector<ObjectInstance*> & instances)
+{
+    QJsonObject entry;
+    entry["op"] = "remove";
+    entry["layer"] = layerId;
+    entry["instances"] = instanceIds(instances);
+    emit journalEntry(entry);
+}
+
+void RoomEditor::journalVisibility(const QString & op, const QString & id, bool visible)
+{
+    QJsonObject entry;
+    entry["op"] = op;
+    entry["id"] = id;
+    entry["visible"] = visible;
+    emit journalEntry(entry);
+}
+
+QVector<ObjectInstance*> RoomEditor::selectedInstances() const
+{
+    QVector<ObjectInstance*> instances;
+    for (auto & item : scene.selectedItems())
+    {
+        if (auto instItem = qgraphicsitem_cast<GraphicsInstance*>(item))
+        {
+            instances.append(instItem->objectInstance());
+        }
+    }
+    return instances;
 }
 
 void RoomEditor::showObjectsListContextMenu(const QPoint & pos)
@@ -210,5 +1353,9 @@ void RoomEditor::showObjectsListContextMenu(const QPoint & pos)
     menu.addAction("Edit object", [this, inst]() {
         emit openObject(inst->object());
     });
+    menu.addSeparator();
+    menu.addAction("Select all instances of the object", [this, inst]() {
+        selectObject(inst->object());
+    });
     menu.exec(ui->objectsListView->mapToGlobal(pos));
 }
@@ -23,9 +23,23 @@
 #include "ui_roomeditor.h"
 #include "models/layersmodel.h"
 #include "models/objectsmodel.h"
+#include "graphics/roomanalysis.h"
+#include <QUndoStack>
+#include <QTimer>
+#include <QSet>
+#include <QPointer>
+#include <functional>
 
 class GraphicsLayer;
+class GraphicsInstance;
 class ObjectResourceItem;
+class SpriteResourceItem;
+class GraphicsRoomView;
+class InstanceSearch;
+class RoomAnalysisDialog;
+class CameraPreview;
+class RoomView;
+class QListWidget;
 class RoomEditor : public MainEditor
 {
     Q_OBJECT
@@ -34,9 +48,28 @@ public:
     explicit RoomEditor(RoomResourceItem* item);
     ~RoomEditor();
 
+    GraphicsRoomView * roomView() const;
+
+    void replay(const QJsonObject & entry) override;
+    void discardChanges() override;
+
+    // used by the undo commands, they don't touch the undo stack
+    void moveInstances(const QVector<ObjectInstance*> & instances, QPointF offset);
+    void insertInstances(const QString & layerId, const QVector<ObjectInstance*> & instances, const QVector<int> & indexes);
+    QVector<int> removeInstances(const QString & layerId, const QVector<ObjectInstance*> & instances);
+    // the instances must have been removed
+    void deleteInstances(const QVector<ObjectInstance*> & instances);
+    void setLayerVisible(const QString & id, bool visible);
+    void setInstanceVisible(ObjectInstance * instance, bool visible);
+
+    // selects the instance on its layer and centers the view on it
+    void showInstance(ObjectInstance * instance);
+
 signals:
     void openObject(ObjectResourceItem * item);
     void openInstance(ObjectInstance* item);
+    // for the instances found in other rooms
+    void showRoomInstance(RoomResourceItem * room, ObjectInstance * instance);
 
 protected slots:
     void save() override;
@@ -49,14 +82,85 @@ private slots:
     void updateSelectedItem(const QModelIndex & index);
     void setInstanceVisibility(QString id, bool visible);
     void showObjectsListContextMenu(const QPoint & pos);
+    void instancesMoved(QPointF offset);
+    void deleteSelection();
+    void duplicateSelection();
+    void selectArea(const QRectF & rect, Qt::KeyboardModifiers modifiers);
+    void selectAll();
+    void selectObject(ObjectResourceItem * object);
+    void invertSelection();
+    void nudgeSelection(QPointF offset);
+    void loadBatch();
+    void exportImage();
+    void searchInstances();
+    void showSearchResult(RoomResourceItem * room, ObjectInstance * instance);
+    void selectSearchResults();
+    void analyzeRoom();
+    void updateCameras();
+    void frameCamera();
 
 private:
+    GraphicsInstance * graphicsInstance(ObjectInstance * instance) const;
+    GraphicsLayer * graphicsLayer(ObjectInstance * instance) const;
+    GraphicsInstance * createGraphicsInstance(ObjectInstance * instance);
+    void journalMove(const QVector<ObjectInstance*> & instances, QPointF offset);
+    void journalInsert(const QString & layerId, const QVector<ObjectInstance*> & instances, const QVector<int> & indexes);
+    void journalRemove(const QString & layerId, const QVector<ObjectInstance*> & instances);
+    void journalVisibility(const QString & op, const QString & id, bool visible);
+    QVector<ObjectInstance*> selectedInstances() const;
+    // replaces the selection, with a single selectionChanged
+    void setSelection(const QVector<GraphicsInstance*> & items, bool add = false);
+    void fillObjectsList();
+    // removes everything built from the room, before it's built again
+    void clearRoom();
+    // the positions of the items are copied in the instances, when saving
+    void commitPositions();
+    // keeps where the item of the instance is, if it's not where the instance is
+    void trackPosition(ObjectInstance * instance, GraphicsInstance * instItem);
+    // decodes the sprite in a worker thread if it's not in the cache
+    void whenSpriteReady(SpriteResourceItem * sprite, std::function<void()> callback);
+    void requestSprite(SpriteResourceItem * sprite);
+    void spriteReady(SpriteResourceItem * sprite);
+    void finishLoading();
+    void setCurrentLayer(const QString & layerId);
+    void showAnalysis(const RoomAnalysis::Report & report);
+    void fillViews();
+    // where the camera is when the room starts
+    QRect cameraRect(RoomView * view);
+    GraphicsInstance * firstInstanceOf(ObjectResourceItem * object);
+
     Ui::RoomEditor *ui;
     LayersModel layersModel;
     ObjectsModel objectsModel;
+    InstanceSearch * m_search = nullptr;
+    QListWidget * m_viewsList = nullptr;
+    QLabel * m_viewsLabel = nullptr;
+    CameraPreview * m_cameraPreview = nullptr;
     QGraphicsScene scene;
     QMap<QString, GraphicsLayer*> graphicsLayers;
     GraphicsLayer * m_currentLayer = nullptr;
+    QString m_currentLayerId;
+    QUndoStack undoStack;
+    // items of the deleted instances, until they are put back
+    QHash<ObjectInstance*, GraphicsInstance*> m_removedItems;
+    // the instances moved in the view, they keep their position until the room is saved
+    QHash<ObjectInstance*, QPoint> m_movedPositions;
+
+    // the room is put in the scene by slices, between two frames
+    QTimer m_loadTimer;
+    QVector<QPair<GraphicsLayer*, ObjectInstance*>> m_loadQueue;
+    int m_loadPosition = 0;
+    int m_loadGeneration = 0;
+    bool m_loading = false;
+    QVector<QJsonObject> m_pendingReplays;
+    ObjectInstance * m_pendingInstance = nullptr;
+    bool m_analyzing = false;
+    QPointer<RoomAnalysisDialog> m_analysisDialog;
+    // the cameras following instances are placed after the edits
+    QTimer m_cameraTimer;
+    QSet<SpriteResourceItem*> m_requestedSprites;
+    QHash<SpriteResourceItem*, QVector<GraphicsInstance*>> m_waitingInstances;
+    QHash<SpriteResourceItem*, QVector<std::function<void()>>> m_spriteCallbacks;
 };
 
 #endif // ROOMEDITOR_H
@@ -18,7 +18,10 @@
 #include "scripteditor.h"
 #include "widgets/codeeditor.h"
 #include "resources/scriptresourceitem.h"
+#include "utils/localhistory.h"
+#include "widgets/historydialog.h"
 #include <QFile>
+#include <QPushButton>
 #include "gamesettings.h"
 #include <QDebug>
 
@@ -29,6 +32,10 @@ ScriptEditor::ScriptEditor(ScriptResourceItem * item)
     setWidget(codeEditor);
 
     connect(codeEditor, &CodeEditor::dirtyChanged, this, qOverload<bool>(&ScriptEditor::setDirty));
+    connect(codeEditor, &CodeEditor::edited, this, &ScriptEditor::journalEntry);
+
+    auto historyButton = addButton("Local history");
+    connect(historyButton, &QPushButton::clicked, this, &ScriptEditor::showHistory);
 
     reset();
 }
@@ -45,10 +52,29 @@ void ScriptEditor::save()
         return;
     }
 
-    f.write(codeEditor->getCode().toLocal8Bit());
+    auto data = codeEditor->getCode().toLocal8Bit();
+    f.write(data);
     f.close();
 
+    LocalHistory::record(item<ScriptResourceItem>()->scriptFilename(), data);
+
     codeEditor->setDirty(false);
+
+    emit saved();
+}
+
+void ScriptEditor::showHistory()
+{
+    HistoryDialog history(item<ScriptResourceItem>()->scriptFilename());
+    if (history.exec())
+    {
+        codeEditor->replaceCode(history.code());
+    }
+}
+
+void ScriptEditor::replay(const QJsonObject & entry)
+{
+    codeEditor->replay(entry);
 }
 
 void ScriptEditor::reset()
@@ -24,13 +24,20 @@
 class CodeEditor;
 class ScriptEditor : public MainEditor
 {
+    Q_OBJECT
+
 public:
     ScriptEditor(ScriptResourceItem* item);
 
+    void replay(const QJsonObject & entry) override;
+
 protected slots:
     void save() override;
     void reset() override;
 
+private slots:
+    void showHistory();
+
 private:
     CodeEditor * codeEditor;
 };
@@ -41,11 +41,63 @@ void GameSettings::setLastOpenedProject(QString filename)
     save();
 }
 
+qreal GameSettings::roomLodScale()
+{
+    return room_lod_scale;
+}
+
+void GameSettings::setRoomLodScale(qreal scale)
+{
+    room_lod_scale = scale;
+
+    save();
+}
+
+int GameSettings::roomGridSize()
+{
+    return room_grid_size;
+}
+
+void GameSettings::setRoomGridSize(int size)
+{
+    room_grid_size = size;
+
+    save();
+}
+
+bool GameSettings::roomGridVisible()
+{
+    return room_grid_visible;
+}
+
+void GameSettings::setRoomGridVisible(bool visible)
+{
+    room_grid_visible = visible;
+
+    save();
+}
+
+bool GameSettings::roomSnapToGrid()
+{
+    return room_snap_to_grid;
+}
+
+void GameSettings::setRoomSnapToGrid(bool snap)
+{
+    room_snap_to_grid = snap;
+
+    save();
+}
+
 void GameSettings::save()
 {
     QSettings settings(qApp->applicationDirPath() + "/configuration.ini", QSettings::IniFormat);
 
     settings.setValue("last_opened_project", last_opened_project);
+    settings.setValue("room_lod_scale", room_lod_scale);
+    settings.setValue("room_grid_size", room_grid_size);
+    settings.setValue("room_grid_visible", room_grid_visible);
+    settings.setValue("room_snap_to_grid", room_snap_to_grid);
 }
 
 void GameSettings::load()
@@ -53,7 +105,15 @@ void GameSettings::load()
     QSettings settings(qApp->applicationDirPath() + "/configuration.ini", QSettings::IniFormat);
 
     last_opened_project = settings.value("last_opened_project").toString();
+    room_lod_scale = settings.value("room_lod_scale", room_lod_scale).toReal();
+    room_grid_size = qMax(1, settings.value("room_grid_size", room_grid_size).toInt());
+    room_grid_visible = settings.value("room_grid_visible", room_grid_visible).toBool();
+    room_snap_to_grid = settings.value("room_snap_to_grid", room_snap_to_grid).toBool();
 }
 
 QString GameSettings::root_path;
 QString GameSettings::last_opened_project;
+qreal GameSettings::room_lod_scale = 0.25;
+int GameSettings::room_grid_size = 32;
+bool GameSettings::room_grid_visible = false;
+bool GameSettings::room_snap_to_grid = false;
@@ -31,12 +31,28 @@ public:
     static QString lastOpenedProject();
     static void setLastOpenedProject(QString filename);
 
+    // below this zoom, room instances are drawn from a downscaled image
+    static qreal roomLodScale();
+    static void setRoomLodScale(qreal scale);
+
+    // in pixels, the grid of the room editor is square
+    static int roomGridSize();
+    static void setRoomGridSize(int size);
+    static bool roomGridVisible();
+    static void setRoomGridVisible(bool visible);
+    static bool roomSnapToGrid();
+    static void setRoomSnapToGrid(bool snap);
+
     static void save();
     static void load();
 
 private:
     static QString root_path;
     static QString last_opened_project;
+    static qreal room_lod_scale;
+    static int room_grid_size;
+    static bool room_grid_visible;
+    static bool room_snap_to_grid;
 };
 
 #endif // GAMESETTINGS_H
@@ -0,0 +1,92 @@
+/*
+    Copyright (C) 2018  Alexander Roper
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "graphicsbackground.h"
+#include "resources/dependencies/backgroundlayer.h"
+#include "resources/spriteresourceitem.h"
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+
+GraphicsBackground::GraphicsBackground(BackgroundLayer * layer, const QSizeF & roomSize)
+    : m_layer { layer }
+    , m_roomRect { QPointF(0, 0), roomSize }
+{
+    setFlag(QGraphicsItem::ItemUsesExtendedStyleOption);
+
+    if (auto sprite = m_layer->sprite())
+        m_pixmap = sprite->pixmap();
+    if (m_pixmap.isNull())
+        return;
+
+    auto position = m_layer->position();
+    QRectF spriteRect(position, m_pixmap.size());
+    if (m_layer->isStretched())
+    {
+        m_boundingRect = m_roomRect;
+    }
+    else if (m_layer->isHTiled() || m_layer->isVTiled())
+    {
+        m_boundingRect = spriteRect;
+        if (m_layer->isHTiled())
+        {
+            m_boundingRect.setLeft(m_roomRect.left());
+            m_boundingRect.setRight(m_roomRect.right());
+        }
+        if (m_layer->isVTiled())
+        {
+            m_boundingRect.setTop(m_roomRect.top());
+            m_boundingRect.setBottom(m_roomRect.bottom());
+        }
+
+        m_brush = QBrush(m_pixmap);
+        m_brush.setTransform(QTransform::fromTranslate(position.x(), position.y()));
+    }
+    else
+    {
+        m_boundingRect = spriteRect;
+    }
+}
+
+QRectF GraphicsBackground::boundingRect() const
+{
+    return m_boundingRect;
+}
+
+void GraphicsBackground::paint(QPainter * painter, const QStyleOptionGraphicsItem * option, QWidget * widget)
+{
+    Q_UNUSED(widget)
+
+    if (m_pixmap.isNull())
+        return;
+
+    if (m_layer->isStretched())
+    {
+        painter->drawPixmap(m_roomRect, m_pixmap, m_pixmap.rect());
+    }
+    else if (m_brush.style() == Qt::TexturePattern)
+    {
+        // only the exposed part is filled
+        auto rect = m_boundingRect;
+        if (!option->exposedRect.isNull())
+            rect &= option->exposedRect;
+        painter->fillRect(rect, m_brush);
+    }
+    else
+    {
+        painter->drawPixmap(m_layer->position(), m_pixmap);
+    }
+}
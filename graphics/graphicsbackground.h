@@ -0,0 +1,46 @@
+/*
+    Copyright (C) 2018  Alexander Roper
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GRAPHICSBACKGROUND_H
+#define GRAPHICSBACKGROUND_H
+
+#include <QGraphicsItem>
+#include <QBrush>
+
+class BackgroundLayer;
+// The sprite of a background layer, tiled or stretched over the room
+class GraphicsBackground : public QGraphicsItem
+{
+public:
+    enum { Type = UserType + 3 };
+
+    GraphicsBackground(BackgroundLayer * layer, const QSizeF & roomSize);
+
+    int type() const override { return Type; }
+    QRectF boundingRect() const override;
+    void paint(QPainter * painter, const QStyleOptionGraphicsItem * option, QWidget * widget) override;
+
+private:
+    BackgroundLayer * m_layer = nullptr;
+    QRectF m_roomRect;
+    QRectF m_boundingRect;
+    QPixmap m_pixmap;
+    // the tiling is done by the brush, whatever the size of the room
+    QBrush m_brush;
+};
+
+#endif // GRAPHICSBACKGROUND_H
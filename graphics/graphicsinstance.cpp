@@ -16,19 +16,36 @@
 */
 
 #include "graphicsinstance.h"
+#include "graphicslayer.h"
+#include "spritecache.h"
+#include "spriteanimator.h"
+#include "gamesettings.h"
 #include "resources/dependencies/objectinstance.h"
+#include "resources/objectresourceitem.h"
+#include "resources/spriteresourceitem.h"
 #include <QIcon>
 #include <QStyleOptionGraphicsItem>
 #include <QDebug>
 #include <QPainter>
 #include <QGraphicsSceneContextMenuEvent>
+#include <QGraphicsScene>
 #include <QMenu>
 
 GraphicsInstance::GraphicsInstance(ObjectInstance * instance)
-    : QGraphicsPixmapItem { QIcon::fromTheme("help-about").pixmap(16, 16) }
-    , m_objectInstance { instance }
+    : m_objectInstance { instance }
 {
-    setFlags(QGraphicsItem::ItemIsMovable | QGraphicsItem::ItemIsSelectable);
+    if (auto object = m_objectInstance->object())
+        m_sprite = object->sprite();
+
+    // the sprite is only used if it's already decoded
+    QPixmap pix;
+    SpriteCache::find(m_sprite, 0, &pix);
+    setSprite(pix);
+
+    // the mask would be computed for each instance
+    setShapeMode(QGraphicsPixmapItem::BoundingRectShape);
+
+    setFlags(QGraphicsItem::ItemIsMovable | QGraphicsItem::ItemIsSelectable | QGraphicsItem::ItemSendsGeometryChanges);
 
     setPos(m_objectInstance->position());
     setToolTip(m_objectInstance->name());
@@ -39,6 +56,80 @@ ObjectInstance * GraphicsInstance::objectInstance() const
     return m_objectInstance;
 }
 
+SpriteResourceItem * GraphicsInstance::sprite() const
+{
+    return m_sprite;
+}
+
+bool GraphicsInstance::hasSprite() const
+{
+    return m_hasSprite;
+}
+
+void GraphicsInstance::updateSprite()
+{
+    setSprite(SpriteCache::pixmap(m_sprite));
+
+    // the bounds changed
+    if (auto layer = static_cast<GraphicsLayer*>(parentItem()))
+    {
+        layer->instanceMoved(this);
+    }
+}
+
+bool GraphicsInstance::isAnimated() const
+{
+    return m_sprite && m_sprite->frameCount() > 1;
+}
+
+void GraphicsInstance::updateFrame()
+{
+    if (!m_hasSprite || !isAnimated())
+        return;
+
+    int frame = SpriteAnimator::instance()->frame(m_sprite);
+    if (frame == m_frame)
+        return;
+
+    // decoded once in a worker thread, then shared by all the instances
+    auto pix = SpriteAnimator::instance()->framePixmap(m_sprite, frame);
+    if (!pix.isNull())
+    {
+        m_frame = frame;
+        setPixmap(pix);
+    }
+}
+
+void GraphicsInstance::setSprite(const QPixmap & pixmap)
+{
+    // the pixmap is shared by all the instances of the sprite
+    m_hasSprite = !pixmap.isNull();
+    m_frame = 0;
+    if (m_hasSprite)
+    {
+        setPixmap(pixmap);
+        setOffset(-m_sprite->origin());
+    }
+    else
+    {
+        static QPixmap placeholder = QIcon::fromTheme("help-about").pixmap(16, 16);
+        setPixmap(placeholder);
+        setOffset(0, 0);
+    }
+}
+
+QVariant GraphicsInstance::itemChange(GraphicsItemChange change, const QVariant & value)
+{
+    // keep the spatial index of the layer up to date
+    if (change == ItemPositionHasChanged)
+    {
+        if (auto layer = static_cast<GraphicsLayer*>(parentItem()))
+        {
+            layer->instanceMoved(this);
+        }
+    }
+    return QGraphicsPixmapItem::itemChange(change, value);
+}
 
 void GraphicsInstance::contextMenuEvent(QGraphicsSceneContextMenuEvent * event)
 {
@@ -51,5 +142,50 @@ void GraphicsInstance::contextMenuEvent(QGraphicsSceneContextMenuEvent * event)
     menu.addAction("Edit object", [this]() {
         emit openObject(this->objectInstance()->object());
     });
+    menu.addSeparator();
+    menu.addAction("Select all instances of the object", [this]() {
+        emit selectObject(this->objectInstance()->object());
+    });
     menu.exec(event->screenPos());
 }
+
+void GraphicsInstance::mousePressEvent(QGraphicsSceneMouseEvent * event)
+{
+    QGraphicsPixmapItem::mousePressEvent(event);
+    m_pressPosition = pos();
+}
+
+void GraphicsInstance::mouseMoveEvent(QGraphicsSceneMouseEvent * event)
+{
+    int size = GameSettings::roomGridSize();
+    if (!GameSettings::roomSnapToGrid() || size <= 0 || !(event->buttons() & Qt::LeftButton))
+    {
+        QGraphicsPixmapItem::mouseMoveEvent(event);
+        return;
+    }
+
+    // the dragged item is snapped, the others keep their distance to it
+    auto target = m_pressPosition + event->scenePos() - event->buttonDownScenePos(Qt::LeftButton);
+    QPointF snapped(qRound(target.x() / size) * size, qRound(target.y() / size) * size);
+    auto offset = snapped - pos();
+    if (offset.isNull())
+        return;
+
+    auto items = scene()->selectedItems();
+    if (!isSelected())
+        items.append(this);
+    for (auto & item : items)
+    {
+        if (item->flags() & ItemIsMovable)
+            item->moveBy(offset.x(), offset.y());
+    }
+}
+
+void GraphicsInstance::mouseReleaseEvent(QGraphicsSceneMouseEvent * event)
+{
+    QGraphicsPixmapItem::mouseReleaseEvent(event);
+    if (pos() != m_pressPosition)
+    {
+        emit moved(pos() - m_pressPosition);
+    }
+}
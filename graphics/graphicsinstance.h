@@ -23,24 +23,51 @@
 
 class ObjectInstance;
 class ObjectResourceItem;
+class SpriteResourceItem;
 class GraphicsInstance : public QObject, public QGraphicsPixmapItem
 {
     Q_OBJECT
 
 public:
+    enum { Type = UserType + 1 };
+
     GraphicsInstance(ObjectInstance * instance);
 
+    int type() const override { return Type; }
     ObjectInstance * objectInstance() const;
+    SpriteResourceItem * sprite() const;
+
+    // the item shows a placeholder until the sprite is decoded
+    bool hasSprite() const;
+    void updateSprite();
+
+    // the sprite has more than one frame
+    bool isAnimated() const;
+    // shows the current frame of the animation, if it changed
+    void updateFrame();
 
 signals:
     void openInstance(ObjectInstance * item);
     void openObject(ObjectResourceItem * item);
+    void selectObject(ObjectResourceItem * item);
+    // emitted by the dragged item, all the selected items moved by the same offset
+    void moved(QPointF offset);
 
 protected:
+    QVariant itemChange(GraphicsItemChange change, const QVariant & value) override;
     void contextMenuEvent(QGraphicsSceneContextMenuEvent * event) override;
+    void mousePressEvent(QGraphicsSceneMouseEvent * event) override;
+    void mouseMoveEvent(QGraphicsSceneMouseEvent * event) override;
+    void mouseReleaseEvent(QGraphicsSceneMouseEvent * event) override;
 
 private:
+    void setSprite(const QPixmap & pixmap);
+
     ObjectInstance * m_objectInstance = nullptr;
+    SpriteResourceItem * m_sprite = nullptr;
+    bool m_hasSprite = false;
+    int m_frame = 0;
+    QPointF m_pressPosition;
 };
 
 #endif // GRAPHICSINSTANCE_H
@@ -17,10 +17,28 @@
 
 #include "graphicslayer.h"
 #include "graphicsinstance.h"
+#include "resources/dependencies/objectinstance.h"
+#include "graphicsroomview.h"
+#include "gamesettings.h"
+#include <QGraphicsScene>
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+#include <QtMath>
+#include <algorithm>
+
+// in pixels of the room, the size of the parts of the zoomed out images
+static const int LOD_CHUNK_SIZE = 1024;
+// in kilobytes, for each layer
+static const int LOD_CACHE_SIZE = 32 * 1024;
+// in pixels, bigger items aren't put in the grid
+static const qreal LARGE_ITEM_SIZE = 4096;
+// the opacity of the faded layers, when another one is edited
+static const qreal FADED_OPACITY = 0.5;
 
 GraphicsLayer::GraphicsLayer()
 {
     setEnabled(false);
+    m_lodChunks.setMaxCost(LOD_CACHE_SIZE);
 }
 
 QRectF GraphicsLayer::boundingRect() const
@@ -35,58 +53,364 @@ void GraphicsLayer::paint(QPainter * painter, const QStyleOptionGraphicsItem * o
     Q_UNUSED(widget)
 }
 
+void GraphicsLayer::addInstance(GraphicsInstance * item)
+{
+    item->setParentItem(this);
+    m_instances.insert(item->objectInstance(), item);
+    if (item->isAnimated())
+        m_animatedCount++;
+    m_grid.insert(item, bounds(item));
+    dirtyLod(bounds(item));
+
+    notifyChanged(bounds(item));
+}
+
+void GraphicsLayer::addItem(QGraphicsItem * item)
+{
+    item->setParentItem(this);
+
+    // a huge item would be in all the cells of the grid
+    auto itemBounds = item->mapRectToParent(item->boundingRect());
+    if (itemBounds.width() > LARGE_ITEM_SIZE || itemBounds.height() > LARGE_ITEM_SIZE)
+        m_largeItems.append(item);
+    else
+        m_grid.insert(item, itemBounds);
+
+    notifyChanged(itemBounds);
+}
+
+GraphicsInstance * GraphicsLayer::removeInstance(ObjectInstance * instance)
+{
+    auto item = m_instances.take(instance);
+    if (item == nullptr)
+        return nullptr;
+    if (item->isAnimated())
+        m_animatedCount--;
+
+    auto oldBounds = m_grid.bounds(item);
+    m_grid.remove(item);
+    dirtyLod(oldBounds);
+
+    auto pScene = scene();
+    item->setParentItem(nullptr);
+    if (pScene)
+        pScene->removeItem(item);
+
+    notifyChanged(oldBounds);
+    return item;
+}
+
+void GraphicsLayer::instanceMoved(GraphicsInstance * item)
+{
+    auto oldBounds = m_grid.bounds(item);
+    m_grid.update(item, bounds(item));
+    dirtyLod(oldBounds | bounds(item));
+
+    notifyChanged(oldBounds | bounds(item));
+}
+
+GraphicsInstance * GraphicsLayer::item(ObjectInstance * instance) const
+{
+    return m_instances.value(instance);
+}
+
+QVector<GraphicsInstance*> GraphicsLayer::instancesIn(const QRectF & rect) const
+{
+    QVector<GraphicsInstance*> result;
+    for (auto & child : m_grid.items(rect))
+    {
+        auto instItem = qgraphicsitem_cast<GraphicsInstance*>(child);
+        if (instItem && instItem->isVisible())
+            result.append(instItem);
+    }
+    return result;
+}
+
+QVector<GraphicsInstance*> GraphicsLayer::instancesAt(const QPointF & point) const
+{
+    QVector<GraphicsInstance*> result;
+    for (auto & child : m_grid.items(point))
+    {
+        auto instItem = qgraphicsitem_cast<GraphicsInstance*>(child);
+        if (instItem && instItem->isVisible() && instItem->contains(instItem->mapFromParent(point)))
+            result.append(instItem);
+    }
+    return result;
+}
+
 void GraphicsLayer::selectItem(ObjectInstance * instance)
 {
-    auto children = childItems();
-    for (auto & child : children)
+    // only the items of the current layer can be selected
+    if (auto pScene = scene())
     {
-        auto pInstance = static_cast<GraphicsInstance*>(child);
-        if (pInstance->objectInstance() == instance)
+        for (auto & selected : pScene->selectedItems())
         {
-            pInstance->setSelected(true);
-        }
-        else
-        {
-            pInstance->setSelected(false);
+            if (selected->parentItem() == this)
+                selected->setSelected(false);
         }
     }
+
+    if (auto pInstance = item(instance))
+    {
+        pInstance->setSelected(true);
+    }
 }
 
 void GraphicsLayer::setElementVisible(ObjectInstance * instance, bool visible)
 {
-    auto children = childItems();
-    for (auto & child : children)
+    if (auto pInstance = item(instance))
     {
-        auto pInstance = static_cast<GraphicsInstance*>(child);
-        if (pInstance->objectInstance() == instance)
-        {
-            pInstance->setVisible(visible);
-            break;
-        }
+        pInstance->setVisible(visible);
+        dirtyLod(bounds(pInstance));
+        notifyChanged(bounds(pInstance));
     }
     update();
 }
 
 bool GraphicsLayer::isElementVisible(ObjectInstance * instance) const
 {
-    auto children = childItems();
-    for (auto & child : children)
+    if (auto pInstance = item(instance))
     {
-        auto pInstance = static_cast<GraphicsInstance*>(child);
-        if (pInstance->objectInstance() == instance)
-        {
-            return pInstance->isVisible();
-        }
+        return pInstance->isVisible();
     }
     return false;
 }
 
+void GraphicsLayer::commitPositions()
+{
+    for (auto & pInstance : m_instances)
+    {
+        pInstance->objectInstance()->setPosition(pInstance->pos().toPoint());
+    }
+}
+
 void GraphicsLayer::setCurrent(bool b)
 {
     setEnabled(b);
 
-    if (b)
-        setOpacity(1);
+    m_current = b;
+    updateOpacity();
+}
+
+void GraphicsLayer::setFaded(bool faded)
+{
+    m_faded = faded;
+    updateOpacity();
+}
+
+void GraphicsLayer::setDepth(int depth, int order)
+{
+    // the scene uses it while the layer isn't cached
+    setZValue(-depth);
+    m_order = order;
+}
+
+void GraphicsLayer::sort(QList<GraphicsLayer*> & layers)
+{
+    std::sort(layers.begin(), layers.end(), [](GraphicsLayer * a, GraphicsLayer * b) {
+        if (a->zValue() != b->zValue())
+            return a->zValue() < b->zValue();
+        return a->m_order > b->m_order;
+    });
+}
+
+bool GraphicsLayer::hasAnimations() const
+{
+    return m_animatedCount > 0;
+}
+
+void GraphicsLayer::setCached(bool cached)
+{
+    m_cached = cached;
+    updateOpacity();
+}
+
+bool GraphicsLayer::isCached() const
+{
+    return m_cached;
+}
+
+void GraphicsLayer::paintCached(QPainter * painter, const QRectF & rect, bool lod, bool editorLook) const
+{
+    if (!isVisible())
+        return;
+
+    auto layerRect = mapRectFromScene(rect);
+    qreal opacity = editorLook ? layerOpacity() : 1;
+
+    // zoomed out, thousands of tiny instances would be drawn
+    if (lod && !m_instances.isEmpty() && painter->worldTransform().m11() < GameSettings::roomLodScale())
+    {
+        paintLod(painter, layerRect, opacity);
+        return;
+    }
+
+    auto children = m_largeItems;
+    children += m_grid.orderedItems(layerRect);
+    paintChildren(painter, layerRect, children, opacity);
+}
+
+bool GraphicsLayer::hasContent(const QRectF & rect) const
+{
+    if (!isVisible())
+        return false;
+
+    auto layerRect = mapRectFromScene(rect);
+    for (auto & item : m_largeItems)
+    {
+        if (item->mapRectToParent(item->boundingRect()).intersects(layerRect))
+            return true;
+    }
+    return m_grid.intersects(layerRect);
+}
+
+QVariant GraphicsLayer::itemChange(GraphicsItemChange change, const QVariant & value)
+{
+    if (change == ItemVisibleHasChanged)
+        notifyChanged(childrenBoundingRect());
+    return QGraphicsItem::itemChange(change, value);
+}
+
+QRectF GraphicsLayer::bounds(GraphicsInstance * item)
+{
+    return item->boundingRect().translated(item->pos());
+}
+
+void GraphicsLayer::paintChildren(QPainter * painter, const QRectF & layerRect, const QVector<QGraphicsItem*> & children, qreal opacity) const
+{
+    for (auto & child : children)
+    {
+        if (!child->isVisible())
+            continue;
+
+        auto childRect = child->mapRectFromParent(layerRect);
+        if (!child->boundingRect().intersects(childRect))
+            continue;
+
+        QStyleOptionGraphicsItem option;
+        option.exposedRect = childRect;
+
+        painter->save();
+        painter->setTransform(child->sceneTransform(), true);
+        painter->setOpacity(opacity * child->opacity());
+        child->paint(painter, &option, nullptr);
+        painter->restore();
+    }
+}
+
+void GraphicsLayer::paintLod(QPainter * painter, const QRectF & layerRect, qreal opacity) const
+{
+    int left = qFloor(layerRect.left() / LOD_CHUNK_SIZE);
+    int top = qFloor(layerRect.top() / LOD_CHUNK_SIZE);
+    int right = qFloor(layerRect.right() / LOD_CHUNK_SIZE);
+    int bottom = qFloor(layerRect.bottom() / LOD_CHUNK_SIZE);
+
+    // the images are made at full opacity, the layer is faded when they are drawn
+    painter->save();
+    painter->setRenderHint(QPainter::SmoothPixmapTransform);
+    painter->setOpacity(opacity);
+    for (int y = top; y <= bottom; y++)
+    {
+        for (int x = left; x <= right; x++)
+        {
+            QRectF chunkRect(x * LOD_CHUNK_SIZE, y * LOD_CHUNK_SIZE, LOD_CHUNK_SIZE, LOD_CHUNK_SIZE);
+            auto image = lodChunk(x, y);
+            if (image == nullptr)
+            {
+                // too big for the cache, the instances are drawn one by one
+                paintChildren(painter, chunkRect & layerRect, m_grid.orderedItems(chunkRect & layerRect), opacity);
+            }
+            else if (!image->isNull())
+            {
+                painter->drawImage(mapRectToScene(chunkRect), *image);
+            }
+        }
+    }
+    painter->restore();
+}
+
+QImage * GraphicsLayer::lodChunk(int x, int y) const
+{
+    auto chunkKey = lodKey(x, y);
+    if (auto image = m_lodChunks.object(chunkKey))
+        return image;
+
+    // the empty chunks are kept as null images, without pixels
+    QRectF chunkRect(x * LOD_CHUNK_SIZE, y * LOD_CHUNK_SIZE, LOD_CHUNK_SIZE, LOD_CHUNK_SIZE);
+    auto children = m_grid.orderedItems(chunkRect);
+    auto image = new QImage;
+    int cost = 1;
+    if (!children.isEmpty())
+    {
+        qreal scale = GameSettings::roomLodScale();
+        int side = qCeil(LOD_CHUNK_SIZE * scale);
+        *image = QImage(side, side, QImage::Format_ARGB32_Premultiplied);
+        image->fill(Qt::transparent);
+
+        QPainter lodPainter(image);
+        lodPainter.setRenderHint(QPainter::SmoothPixmapTransform);
+        lodPainter.scale(scale, scale);
+        lodPainter.translate(-chunkRect.topLeft());
+        paintChildren(&lodPainter, chunkRect, children, 1);
+        lodPainter.end();
+
+        // in kilobytes
+        cost = qMax(1, side * side * 4 / 1024);
+    }
+
+    // the cache deletes the image when it can't hold it
+    if (!m_lodChunks.insert(chunkKey, image, cost))
+        return nullptr;
+    return image;
+}
+
+void GraphicsLayer::dirtyLod(const QRectF & rect)
+{
+    int left = qFloor(rect.left() / LOD_CHUNK_SIZE);
+    int top = qFloor(rect.top() / LOD_CHUNK_SIZE);
+    int right = qFloor(rect.right() / LOD_CHUNK_SIZE);
+    int bottom = qFloor(rect.bottom() / LOD_CHUNK_SIZE);
+    if (qint64(right - left + 1) * (bottom - top + 1) > m_lodChunks.size())
+    {
+        m_lodChunks.clear();
+        return;
+    }
+
+    for (int y = top; y <= bottom; y++)
+    {
+        for (int x = left; x <= right; x++)
+            m_lodChunks.remove(lodKey(x, y));
+    }
+}
+
+quint64 GraphicsLayer::lodKey(int x, int y)
+{
+    return (quint64(quint32(x)) << 32) | quint32(y);
+}
+
+void GraphicsLayer::updateOpacity()
+{
+    // children of a fully transparent item are skipped by the scene
+    if (m_cached)
+        setOpacity(0);
     else
-        setOpacity(0.5);
+        setOpacity(layerOpacity());
+}
+
+qreal GraphicsLayer::layerOpacity() const
+{
+    return m_faded && !m_current ? FADED_OPACITY : 1;
+}
+
+void GraphicsLayer::notifyChanged(const QRectF & rect)
+{
+    if (auto pScene = scene())
+    {
+        auto sceneRect = mapRectToScene(rect);
+        for (auto & view : pScene->views())
+        {
+            if (auto roomView = qobject_cast<GraphicsRoomView*>(view))
+                roomView->layerChanged(this, sceneRect);
+        }
+    }
 }
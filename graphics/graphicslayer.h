@@ -18,9 +18,13 @@
 #ifndef GRAPHICSLAYER_H
 #define GRAPHICSLAYER_H
 
+#include "spatialgrid.h"
 #include <QGraphicsItem>
+#include <QImage>
+#include <QCache>
 
 class ObjectInstance;
+class GraphicsInstance;
 class GraphicsLayer : public QGraphicsItem
 {
 public:
@@ -29,11 +33,72 @@ public:
     QRectF boundingRect() const override;
     void paint(QPainter * painter, const QStyleOptionGraphicsItem * option, QWidget * widget) override;
 
+    void addInstance(GraphicsInstance * item);
+    // the other items: backgrounds, tiles...
+    void addItem(QGraphicsItem * item);
+    // the item is taken out of the scene and given to the caller
+    GraphicsInstance * removeInstance(ObjectInstance * instance);
+    void instanceMoved(GraphicsInstance * item);
+
+    GraphicsInstance * item(ObjectInstance * instance) const;
+    // visible instances intersecting the rect or under the point, in layer coordinates
+    QVector<GraphicsInstance*> instancesIn(const QRectF & rect) const;
+    QVector<GraphicsInstance*> instancesAt(const QPointF & point) const;
     void selectItem(ObjectInstance * instance);
     void setElementVisible(ObjectInstance * instance, bool visible);
     bool isElementVisible(ObjectInstance * instance) const;
+    void commitPositions();
 
     void setCurrent(bool b);
+    // faded while it isn't the current layer
+    void setFaded(bool faded);
+
+    // the order is the index of the layer in the room
+    void setDepth(int depth, int order);
+    // in painting order: by decreasing depth, and the first layers
+    // of the room above the others at the same depth
+    static void sort(QList<GraphicsLayer*> & layers);
+    // some instances have an animated sprite
+    bool hasAnimations() const;
+
+    // a cached layer isn't painted by the scene, the view paints it in its tiles
+    void setCached(bool cached);
+    bool isCached() const;
+    // without lod, the instances are always drawn one by one; without
+    // the look of the editor, the layer isn't faded
+    void paintCached(QPainter * painter, const QRectF & rect, bool lod = true, bool editorLook = true) const;
+    // something would be painted in the rect, in scene coordinates
+    bool hasContent(const QRectF & rect) const;
+
+protected:
+    QVariant itemChange(GraphicsItemChange change, const QVariant & value) override;
+
+private:
+    static QRectF bounds(GraphicsInstance * item);
+    void paintChildren(QPainter * painter, const QRectF & layerRect, const QVector<QGraphicsItem*> & children, qreal opacity) const;
+    void paintLod(QPainter * painter, const QRectF & layerRect, qreal opacity) const;
+    // null when the image doesn't fit in the cache
+    QImage * lodChunk(int x, int y) const;
+    void dirtyLod(const QRectF & rect);
+    static quint64 lodKey(int x, int y);
+    void updateOpacity();
+    qreal layerOpacity() const;
+    // tells the views a region of the layer must be drawn again
+    void notifyChanged(const QRectF & rect);
+
+    bool m_current = false;
+    bool m_faded = false;
+    int m_order = 0;
+    bool m_cached = false;
+
+    // the instances drawn at a reduced scale, for zoomed out views,
+    // only for the parts of the room where there are instances
+    mutable QCache<quint64, QImage> m_lodChunks;
+
+    QHash<ObjectInstance*, GraphicsInstance*> m_instances;
+    int m_animatedCount = 0;
+    SpatialGrid m_grid;
+    QVector<QGraphicsItem*> m_largeItems;
 };
 
 #endif // GRAPHICSLAYER_H
@@ -0,0 +1,492 @@
+/*
+    Copyright (C) 2018  Alexander Roper
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "graphicsroomview.h"
+#include "graphicslayer.h"
+#include "graphicsinstance.h"
+#include "spriteanimator.h"
+#include "gamesettings.h"
+#include <QtMath>
+#include <QPainter>
+#include <QWheelEvent>
+#include <QMouseEvent>
+#include <QContextMenuEvent>
+#include <algorithm>
+
+// in device pixels
+static const int TILE_SIZE = 256;
+// in kilobytes
+static const int CACHE_SIZE = 128 * 1024;
+static const qreal MIN_ZOOM = 1 / 16.0;
+static const qreal MAX_ZOOM = 16;
+// in pixels on screen, a closer grid isn't drawn
+static const qreal MIN_GRID_SPACING = 4;
+
+bool GraphicsRoomView::TileKey::operator==(const TileKey & other) const
+{
+    return plane == other.plane && zoom == other.zoom && x == other.x && y == other.y;
+}
+
+uint qHash(const GraphicsRoomView::TileKey & key, uint seed)
+{
+    return qHash(qMakePair(qMakePair(int(key.plane), key.zoom), qMakePair(key.x, key.y)), seed);
+}
+
+GraphicsRoomView::GraphicsRoomView(QWidget * parent)
+    : QGraphicsView { parent }
+    , m_tiles { CACHE_SIZE }
+{
+    setViewportUpdateMode(QGraphicsView::SmartViewportUpdate);
+}
+
+void GraphicsRoomView::setRoomSize(const QSize & size)
+{
+    m_roomSize = size;
+    viewport()->update();
+    emit contentChanged(QRectF());
+}
+
+void GraphicsRoomView::setLayers(QList<GraphicsLayer*> layers)
+{
+    for (auto & layer : m_layers)
+    {
+        if (!layers.contains(layer))
+            layer->setCached(false);
+    }
+
+    GraphicsLayer::sort(layers);
+    m_layers = layers;
+
+    if (!m_layers.contains(m_activeLayer))
+        m_activeLayer = nullptr;
+    setActiveLayer(m_activeLayer);
+}
+
+void GraphicsRoomView::setActiveLayer(GraphicsLayer * layer)
+{
+    m_activeLayer = layer;
+    updateCachedLayers();
+    // the other layers are drawn with another opacity
+    emit contentChanged(QRectF());
+}
+
+GraphicsLayer * GraphicsRoomView::activeLayer() const
+{
+    return m_activeLayer;
+}
+
+QList<GraphicsLayer*> GraphicsRoomView::layers() const
+{
+    return m_layers;
+}
+
+QSize GraphicsRoomView::roomSize() const
+{
+    return m_roomSize;
+}
+
+qreal GraphicsRoomView::zoom() const
+{
+    return transform().m11();
+}
+
+void GraphicsRoomView::setZoom(qreal zoom)
+{
+    zoom = qBound(MIN_ZOOM, zoom, MAX_ZOOM);
+    setTransform(QTransform::fromScale(zoom, zoom));
+
+    bool lod = zoom < GameSettings::roomLodScale();
+    if (lod != m_lod)
+    {
+        m_lod = lod;
+        updateCachedLayers();
+    }
+}
+
+void GraphicsRoomView::setHeatmap(const QImage & heatmap, int cellSize)
+{
+    m_heatmap = heatmap;
+    m_heatmapCellSize = cellSize;
+    viewport()->update();
+}
+
+void GraphicsRoomView::setCameras(const QVector<QRect> & cameras, int current)
+{
+    m_cameras = cameras;
+    m_currentCamera = current;
+    viewport()->update();
+}
+
+void GraphicsRoomView::beginBatch()
+{
+    m_batchDepth++;
+}
+
+void GraphicsRoomView::endBatch()
+{
+    if (m_batchDepth == 0 || --m_batchDepth > 0)
+        return;
+
+    if (m_batchAll)
+        invalidateCache();
+    else if (!m_batchRect.isNull())
+        invalidateCache(m_batchRect);
+
+    if (!m_batchContent.isNull())
+        emit contentChanged(m_batchContent);
+
+    m_batchAll = false;
+    m_batchRect = QRectF();
+    m_batchContent = QRectF();
+}
+
+void GraphicsRoomView::layerChanged(GraphicsLayer * layer, const QRectF & rect)
+{
+    if (layer == m_activeLayer)
+        updateAnimation();
+
+    if (layer->isCached())
+        invalidateCache(rect);
+
+    if (m_batchDepth > 0)
+        m_batchContent |= rect;
+    else
+        emit contentChanged(rect);
+}
+
+void GraphicsRoomView::invalidateCache(const QRectF & rect)
+{
+    if (m_batchDepth > 0)
+    {
+        if (rect.isNull())
+            m_batchAll = true;
+        else
+            m_batchRect |= rect;
+        return;
+    }
+
+    if (rect.isNull())
+    {
+        m_tiles.clear();
+        viewport()->update();
+        return;
+    }
+
+    for (auto & key : m_tiles.keys())
+    {
+        if (tileRect(key).intersects(rect))
+            m_tiles.remove(key);
+    }
+    viewport()->update(mapFromScene(rect).boundingRect().adjusted(-1, -1, 1, 1));
+}
+
+void GraphicsRoomView::drawBackground(QPainter * painter, const QRectF & rect)
+{
+    QGraphicsView::drawBackground(painter, rect);
+
+    if (!m_roomSize.isEmpty())
+    {
+        painter->setPen(QPen(Qt::black, 0));
+        painter->setBrush(Qt::white);
+        painter->drawRect(QRectF(QPointF(0, 0), m_roomSize));
+    }
+
+    drawTiles(painter, rect, Plane::Below);
+}
+
+void GraphicsRoomView::drawForeground(QPainter * painter, const QRectF & rect)
+{
+    drawTiles(painter, rect, Plane::Above);
+
+    if (!m_heatmap.isNull())
+        drawHeatmap(painter, rect);
+
+    if (GameSettings::roomGridVisible())
+        drawGrid(painter, rect);
+
+    if (!m_cameras.isEmpty())
+        drawCameras(painter, rect);
+
+    QGraphicsView::drawForeground(painter, rect);
+}
+
+void GraphicsRoomView::wheelEvent(QWheelEvent * event)
+{
+    if (event->modifiers() & Qt::ControlModifier)
+    {
+        auto anchor = transformationAnchor();
+        setTransformationAnchor(QGraphicsView::AnchorUnderMouse);
+        setZoom(event->angleDelta().y() > 0 ? zoom() * 1.25 : zoom() / 1.25);
+        setTransformationAnchor(anchor);
+        event->accept();
+        return;
+    }
+
+    QGraphicsView::wheelEvent(event);
+}
+
+void GraphicsRoomView::contextMenuEvent(QContextMenuEvent * event)
+{
+    // the items have their own menu
+    QGraphicsView::contextMenuEvent(event);
+    if (!event->isAccepted())
+    {
+        event->accept();
+        emit roomMenuRequested(event->globalPos());
+    }
+}
+
+void GraphicsRoomView::mousePressEvent(QMouseEvent * event)
+{
+    // the band is done here so the instances are found with the index of the layer
+    bool onInstance = m_activeLayer && !m_activeLayer->instancesAt(mapToScene(event->pos())).isEmpty();
+    if (event->button() == Qt::LeftButton && m_activeLayer && !m_lod && !onInstance)
+    {
+        if (m_rubberBand == nullptr)
+            m_rubberBand = new QRubberBand(QRubberBand::Rectangle, viewport());
+
+        m_rubberBandOrigin = event->pos();
+        m_rubberBand->setGeometry(QRect(m_rubberBandOrigin, QSize()));
+        m_rubberBand->show();
+        event->accept();
+        return;
+    }
+
+    QGraphicsView::mousePressEvent(event);
+}
+
+void GraphicsRoomView::mouseMoveEvent(QMouseEvent * event)
+{
+    if (m_rubberBand && m_rubberBand->isVisible())
+    {
+        m_rubberBand->setGeometry(QRect(m_rubberBandOrigin, event->pos()).normalized());
+        event->accept();
+        return;
+    }
+
+    QGraphicsView::mouseMoveEvent(event);
+}
+
+void GraphicsRoomView::mouseReleaseEvent(QMouseEvent * event)
+{
+    if (m_rubberBand && m_rubberBand->isVisible())
+    {
+        m_rubberBand->hide();
+        // a simple click gives an empty area
+        auto rect = QRect(m_rubberBandOrigin, event->pos()).normalized();
+        emit areaSelected(mapToScene(rect).boundingRect(), event->modifiers());
+        event->accept();
+        return;
+    }
+
+    QGraphicsView::mouseReleaseEvent(event);
+}
+
+void GraphicsRoomView::drawTiles(QPainter * painter, const QRectF & rect, Plane plane)
+{
+    if (planeLayers(plane).isEmpty())
+        return;
+
+    // tiles are the same size on screen whatever the zoom
+    int zoomKey = qRound(zoom() * 1000);
+    qreal scale = zoomKey / 1000.0;
+    int left = qFloor(rect.left() * scale / TILE_SIZE);
+    int top = qFloor(rect.top() * scale / TILE_SIZE);
+    int right = qFloor(rect.right() * scale / TILE_SIZE);
+    int bottom = qFloor(rect.bottom() * scale / TILE_SIZE);
+
+    painter->save();
+    painter->setRenderHint(QPainter::SmoothPixmapTransform, false);
+    for (int y = top; y <= bottom; y++)
+    {
+        for (int x = left; x <= right; x++)
+        {
+            TileKey key { plane, zoomKey, x, y };
+            auto pix = tile(key);
+            if (pix && !pix->isNull())
+            {
+                painter->drawPixmap(tileRect(key), *pix, pix->rect());
+            }
+        }
+    }
+    painter->restore();
+}
+
+void GraphicsRoomView::drawGrid(QPainter * painter, const QRectF & rect)
+{
+    // the lines are drawn only in the exposed part of the room,
+    // and skipped when they would be too close on screen
+    int size = GameSettings::roomGridSize();
+    if (size <= 0 || size * zoom() < MIN_GRID_SPACING)
+        return;
+
+    auto area = rect & QRectF(QPointF(0, 0), m_roomSize);
+    if (area.isEmpty())
+        return;
+
+    QVector<QLineF> lines;
+    for (int x = qCeil(area.left() / size) * size; x <= area.right(); x += size)
+        lines.append(QLineF(x, area.top(), x, area.bottom()));
+    for (int y = qCeil(area.top() / size) * size; y <= area.bottom(); y += size)
+        lines.append(QLineF(area.left(), y, area.right(), y));
+
+    painter->save();
+    painter->setRenderHint(QPainter::Antialiasing, false);
+    painter->setPen(QPen(QColor(0, 0, 0, 64), 0));
+    painter->drawLines(lines);
+    painter->restore();
+}
+
+void GraphicsRoomView::drawHeatmap(QPainter * painter, const QRectF & rect)
+{
+    // only the cells in the exposed part are scaled
+    QRectF heatRect(0, 0, m_heatmap.width() * m_heatmapCellSize, m_heatmap.height() * m_heatmapCellSize);
+    auto area = rect & heatRect;
+    if (area.isEmpty())
+        return;
+
+    QRect cells(QPoint(qFloor(area.left() / m_heatmapCellSize), qFloor(area.top() / m_heatmapCellSize)),
+                QPoint(qCeil(area.right() / m_heatmapCellSize) - 1, qCeil(area.bottom() / m_heatmapCellSize) - 1));
+    cells &= m_heatmap.rect();
+    QRectF target(cells.topLeft() * m_heatmapCellSize, cells.size() * m_heatmapCellSize);
+
+    painter->save();
+    painter->setRenderHint(QPainter::SmoothPixmapTransform, false);
+    painter->drawImage(target, m_heatmap, cells);
+    painter->restore();
+}
+
+void GraphicsRoomView::drawCameras(QPainter * painter, const QRectF & rect)
+{
+    painter->save();
+    painter->setRenderHint(QPainter::Antialiasing, false);
+    painter->setBrush(Qt::NoBrush);
+    for (int i = 0; i < m_cameras.size(); i++)
+    {
+        auto & camera = m_cameras[i];
+        if (camera.isNull() || !rect.intersects(camera))
+            continue;
+
+        QColor color = i == m_currentCamera ? QColor(255, 128, 0) : QColor(0, 160, 255);
+        QPen pen(color, 2, i == m_currentCamera ? Qt::SolidLine : Qt::DashLine);
+        pen.setCosmetic(true);
+        painter->setPen(pen);
+        painter->drawRect(camera);
+
+        // the number keeps its size whatever the zoom
+        auto corner = painter->transform().map(QPointF(camera.topLeft()));
+        painter->save();
+        painter->resetTransform();
+        painter->setPen(color);
+        painter->drawText(corner + QPointF(4, 14), QString("View %1").arg(i));
+        painter->restore();
+    }
+    painter->restore();
+}
+
+QPixmap * GraphicsRoomView::tile(const TileKey & key)
+{
+    if (auto pix = m_tiles.object(key))
+        return pix;
+
+    auto sceneRect = tileRect(key);
+    qreal scale = key.zoom / 1000.0;
+
+    // most of a huge room is empty, those tiles have no pixels
+    auto layers = planeLayers(key.plane);
+    bool empty = std::none_of(layers.cbegin(), layers.cend(), [&sceneRect](GraphicsLayer * layer) {
+        return layer->hasContent(sceneRect);
+    });
+    if (empty)
+    {
+        m_tiles.insert(key, new QPixmap, 1);
+        return m_tiles.object(key);
+    }
+
+    auto pix = new QPixmap(TILE_SIZE, TILE_SIZE);
+    pix->fill(Qt::transparent);
+
+    QPainter painter(pix);
+    painter.scale(scale, scale);
+    painter.translate(-sceneRect.topLeft());
+    for (auto & layer : layers)
+    {
+        layer->paintCached(&painter, sceneRect);
+    }
+    painter.end();
+
+    // the cost is the size in kilobytes
+    m_tiles.insert(key, pix, TILE_SIZE * TILE_SIZE * 4 / 1024);
+    return m_tiles.object(key);
+}
+
+QRectF GraphicsRoomView::tileRect(const TileKey & key) const
+{
+    qreal size = TILE_SIZE / (key.zoom / 1000.0);
+    return QRectF(key.x * size, key.y * size, size, size);
+}
+
+QList<GraphicsLayer*> GraphicsRoomView::planeLayers(Plane plane) const
+{
+    int active = m_lod ? -1 : m_layers.indexOf(m_activeLayer);
+    if (active == -1)
+        return plane == Plane::Below ? m_layers : QList<GraphicsLayer*>();
+
+    if (plane == Plane::Below)
+        return m_layers.mid(0, active);
+    return m_layers.mid(active + 1);
+}
+
+void GraphicsRoomView::updateCachedLayers()
+{
+    // the instances of the active layer can't be edited while zoomed out
+    for (auto & pLayer : m_layers)
+    {
+        pLayer->setCached(m_lod || pLayer != m_activeLayer);
+    }
+
+    // the layers changed planes
+    invalidateCache();
+    updateAnimation();
+}
+
+void GraphicsRoomView::updateAnimation()
+{
+    auto animator = SpriteAnimator::instance();
+    if (!m_lod && m_activeLayer && m_activeLayer->hasAnimations())
+    {
+        animator->addClient(this);
+        connect(animator, &SpriteAnimator::tick, this, &GraphicsRoomView::animate, Qt::UniqueConnection);
+    }
+    else
+    {
+        animator->removeClient(this);
+    }
+}
+
+void GraphicsRoomView::animate()
+{
+    if (m_activeLayer == nullptr || !isVisible())
+        return;
+
+    // only the instances on screen are drawn again
+    auto visible = mapToScene(viewport()->rect()).boundingRect();
+    for (auto & instItem : m_activeLayer->instancesIn(m_activeLayer->mapRectFromScene(visible)))
+    {
+        instItem->updateFrame();
+    }
+}
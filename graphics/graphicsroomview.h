@@ -0,0 +1,125 @@
+/*
+    Copyright (C) 2018  Alexander Roper
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GRAPHICSROOMVIEW_H
+#define GRAPHICSROOMVIEW_H
+
+#include <QGraphicsView>
+#include <QCache>
+#include <QPixmap>
+#include <QImage>
+#include <QRubberBand>
+
+class GraphicsLayer;
+class GraphicsRoomView : public QGraphicsView
+{
+    Q_OBJECT
+
+public:
+    explicit GraphicsRoomView(QWidget * parent = nullptr);
+
+    void setRoomSize(const QSize & size);
+    // all the layers of the room, the active one is drawn live,
+    // the others are rendered in tiles below or above it
+    void setLayers(QList<GraphicsLayer*> layers);
+    void setActiveLayer(GraphicsLayer * layer);
+    GraphicsLayer * activeLayer() const;
+    QList<GraphicsLayer*> layers() const;
+    QSize roomSize() const;
+
+    // invalidations between begin and end are done at once by endBatch
+    void beginBatch();
+    void endBatch();
+
+    qreal zoom() const;
+    void setZoom(qreal zoom);
+
+    // drawn over the room, each pixel of the image covers a square cell,
+    // a null image removes it
+    void setHeatmap(const QImage & heatmap, int cellSize);
+    // the cameras of the views of the room, outlined with their number,
+    // a null rect for a view not shown
+    void setCameras(const QVector<QRect> & cameras, int current = -1);
+
+public slots:
+    // a null rect invalidates everything
+    void invalidateCache(const QRectF & rect = QRectF());
+    // the cache is only invalidated if the layer is in it
+    void layerChanged(GraphicsLayer * layer, const QRectF & rect);
+
+signals:
+    // rubber band selection in the active layer, in scene coordinates
+    void areaSelected(const QRectF & rect, Qt::KeyboardModifiers modifiers);
+    // something was drawn differently in the rect, a null rect for everything
+    void contentChanged(const QRectF & rect);
+    // context menu outside of the items
+    void roomMenuRequested(const QPoint & globalPos);
+
+protected:
+    void drawBackground(QPainter * painter, const QRectF & rect) override;
+    void drawForeground(QPainter * painter, const QRectF & rect) override;
+    void wheelEvent(QWheelEvent * event) override;
+    void contextMenuEvent(QContextMenuEvent * event) override;
+    void mousePressEvent(QMouseEvent * event) override;
+    void mouseMoveEvent(QMouseEvent * event) override;
+    void mouseReleaseEvent(QMouseEvent * event) override;
+
+private:
+    enum class Plane { Below, Above };
+
+    struct TileKey
+    {
+        Plane plane;
+        int zoom;
+        int x;
+        int y;
+
+        bool operator==(const TileKey & other) const;
+    };
+    friend uint qHash(const TileKey & key, uint seed);
+
+    void drawTiles(QPainter * painter, const QRectF & rect, Plane plane);
+    void drawGrid(QPainter * painter, const QRectF & rect);
+    void drawHeatmap(QPainter * painter, const QRectF & rect);
+    void drawCameras(QPainter * painter, const QRectF & rect);
+    QPixmap * tile(const TileKey & key);
+    QRectF tileRect(const TileKey & key) const;
+    QList<GraphicsLayer*> planeLayers(Plane plane) const;
+    void updateCachedLayers();
+    // only the active layer is animated, the others are in the cache
+    void updateAnimation();
+    void animate();
+
+    QSize m_roomSize;
+    QList<GraphicsLayer*> m_layers;
+    GraphicsLayer * m_activeLayer = nullptr;
+    // zoomed out, the active layer is cached too
+    bool m_lod = false;
+    QCache<TileKey, QPixmap> m_tiles;
+    int m_batchDepth = 0;
+    QRectF m_batchRect;
+    bool m_batchAll = false;
+    QRectF m_batchContent;
+    QRubberBand * m_rubberBand = nullptr;
+    QImage m_heatmap;
+    int m_heatmapCellSize = 0;
+    QVector<QRect> m_cameras;
+    int m_currentCamera = -1;
+    QPoint m_rubberBandOrigin;
+};
+
+#endif // GRAPHICSROOMVIEW_H
@@ -0,0 +1,88 @@
+/*
+    Copyright (C) 2018  Alexander Roper
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "graphicstilechunk.h"
+#include "resources/dependencies/tilelayer.h"
+#include "resources/tilesetresourceitem.h"
+#include "resources/spriteresourceitem.h"
+
+GraphicsTileChunk::GraphicsTileChunk(TileLayer * layer, const QPoint & chunk)
+    : m_layer { layer }
+    , m_chunk { chunk }
+{
+    updateTiles();
+}
+
+QRectF GraphicsTileChunk::boundingRect() const
+{
+    return m_boundingRect;
+}
+
+void GraphicsTileChunk::paint(QPainter * painter, const QStyleOptionGraphicsItem * option, QWidget * widget)
+{
+    Q_UNUSED(option)
+    Q_UNUSED(widget)
+
+    auto tileSet = m_layer->tileSet();
+    if (m_fragments.isEmpty() || tileSet == nullptr || tileSet->sprite() == nullptr)
+        return;
+
+    painter->drawPixmapFragments(m_fragments.constData(), m_fragments.size(), tileSet->sprite()->pixmap());
+}
+
+void GraphicsTileChunk::updateTiles()
+{
+    prepareGeometryChange();
+    m_fragments.clear();
+    m_boundingRect = QRectF();
+
+    auto tileSet = m_layer->tileSet();
+    if (tileSet == nullptr || tileSet->tileSize().isEmpty())
+        return;
+
+    auto tileSize = tileSet->tileSize();
+    auto tiles = m_layer->chunk(m_chunk);
+    QPoint first = m_chunk * TileLayer::CHUNK_SIZE;
+
+    m_boundingRect = QRectF(QPointF(first.x() * tileSize.width(), first.y() * tileSize.height()) + m_layer->offset(),
+                            QSizeF(tileSize * TileLayer::CHUNK_SIZE));
+
+    for (int i = 0; i < tiles.size(); i++)
+    {
+        auto tile = tiles[i];
+        if (TileLayer::isEmpty(tile))
+            continue;
+
+        auto source = tileSet->tileRect(tile & TileLayer::TILE_INDEX);
+        if (source.isNull())
+            continue;
+
+        // fragments are placed by their center
+        QPointF center = m_boundingRect.topLeft()
+                + QPointF((i % TileLayer::CHUNK_SIZE + 0.5) * tileSize.width(),
+                          (i / TileLayer::CHUNK_SIZE + 0.5) * tileSize.height());
+
+        auto fragment = QPainter::PixmapFragment::create(center, source);
+        if (tile & TileLayer::TILE_MIRROR)
+            fragment.scaleX = -1;
+        if (tile & TileLayer::TILE_FLIP)
+            fragment.scaleY = -1;
+        if (tile & TileLayer::TILE_ROTATE)
+            fragment.rotation = 90;
+        m_fragments.append(fragment);
+    }
+}
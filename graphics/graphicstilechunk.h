@@ -0,0 +1,47 @@
+/*
+    Copyright (C) 2018  Alexander Roper
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GRAPHICSTILECHUNK_H
+#define GRAPHICSTILECHUNK_H
+
+#include <QGraphicsItem>
+#include <QPainter>
+
+class TileLayer;
+// One chunk of a tile layer, its tiles are drawn in a single call
+class GraphicsTileChunk : public QGraphicsItem
+{
+public:
+    enum { Type = UserType + 2 };
+
+    GraphicsTileChunk(TileLayer * layer, const QPoint & chunk);
+
+    int type() const override { return Type; }
+    QRectF boundingRect() const override;
+    void paint(QPainter * painter, const QStyleOptionGraphicsItem * option, QWidget * widget) override;
+
+    // to call after the tiles of the chunk changed
+    void updateTiles();
+
+private:
+    TileLayer * m_layer = nullptr;
+    QPoint m_chunk;
+    QRectF m_boundingRect;
+    QVector<QPainter::PixmapFragment> m_fragments;
+};
+
+#endif // GRAPHICSTILECHUNK_H
@@ -0,0 +1,304 @@
+/*
+    Copyright (C) 2018  Alexander Roper
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "roomanalysis.h"
+#include "resources/roomresourceitem.h"
+#include "resources/objectresourceitem.h"
+#include "resources/spriteresourceitem.h"
+#include "resources/tilesetresourceitem.h"
+#include "resources/dependencies/backgroundlayer.h"
+#include "resources/dependencies/instancelayer.h"
+#include "resources/dependencies/objectinstance.h"
+#include "resources/dependencies/tilelayer.h"
+#include <QColor>
+#include <QHash>
+#include <QMap>
+#include <QSet>
+#include <QtMath>
+#include <algorithm>
+#include <numeric>
+
+// in pixels, the size of the texture pages, GameMaker's default
+static const qint64 PAGE_SIZE = 2048;
+// in pixels, the space kept around each frame on a page
+static const int PAGE_PADDING = 2;
+// in pixels, the size of the cells of the collision estimate
+static const int CELL_SIZE = 128;
+// cells listed in the report
+static const int HOT_SPOT_COUNT = 5;
+
+RoomAnalysis::Snapshot RoomAnalysis::snapshot(RoomResourceItem * room, const QHash<ObjectInstance*, QPoint> & positions)
+{
+    Snapshot snapshot;
+    snapshot.roomName = room->name();
+    snapshot.roomSize = QSize(room->width(), room->height());
+
+    QHash<SpriteResourceItem*, int> spriteIndexes;
+    for (auto & id : ResourceItem::findAll(ResourceType::Sprite))
+    {
+        auto pSprite = ResourceItem::get<SpriteResourceItem>(id);
+        if (pSprite == nullptr)
+            continue;
+
+        spriteIndexes.insert(pSprite, snapshot.sprites.size());
+        snapshot.sprites.append({ pSprite->name(), pSprite->textureGroupId(), pSprite->size(),
+                                  pSprite->frameCount(), pSprite->origin(), pSprite->boundingBox() });
+    }
+    auto spriteIndex = [&spriteIndexes](SpriteResourceItem * sprite) {
+        return sprite ? spriteIndexes.value(sprite, -1) : -1;
+    };
+
+    QHash<ObjectResourceItem*, int> objectIndexes;
+    auto objectIndex = [&](ObjectResourceItem * object) {
+        auto it = objectIndexes.constFind(object);
+        if (it != objectIndexes.constEnd())
+            return it.value();
+
+        int index = snapshot.objects.size();
+        if (object)
+            snapshot.objects.append({ object->name(), spriteIndex(object->sprite()), spriteIndex(object->maskSprite()), object->isVisible() });
+        else
+            snapshot.objects.append({ "<undefined>", -1, -1, false });
+        objectIndexes.insert(object, index);
+        return index;
+    };
+
+    auto layers = room->layers();
+    for (int i = 0; i < layers.size(); i++)
+    {
+        auto layer = layers[i];
+        Snapshot::Layer layerSnapshot { layer->depth(), i, -1, {} };
+        if (auto bgLayer = qobject_cast<BackgroundLayer*>(layer))
+        {
+            layerSnapshot.sprite = spriteIndex(bgLayer->sprite());
+        }
+        else if (auto tileLayer = qobject_cast<TileLayer*>(layer))
+        {
+            if (auto tileSet = tileLayer->tileSet())
+                layerSnapshot.sprite = spriteIndex(tileSet->sprite());
+        }
+        else if (auto instLayer = qobject_cast<InstanceLayer*>(layer))
+        {
+            auto instances = instLayer->instances();
+            layerSnapshot.instances.reserve(instances.size());
+            for (auto & instance : instances)
+            {
+                layerSnapshot.instances.append({ objectIndex(instance->object()), positions.value(instance, instance->position()) });
+            }
+        }
+        snapshot.layers.append(layerSnapshot);
+    }
+
+    return snapshot;
+}
+
+// the pages are guessed by filling them in the order of the names,
+// within each texture group
+static QVector<int> texturePages(const QVector<RoomAnalysis::Snapshot::Sprite> & sprites)
+{
+    QMap<QString, QVector<int>> groups;
+    for (int i = 0; i < sprites.size(); i++)
+    {
+        groups[sprites[i].textureGroup].append(i);
+    }
+
+    QVector<int> pages(sprites.size(), -1);
+    int firstPage = 0;
+    for (auto & group : groups)
+    {
+        std::sort(group.begin(), group.end(), [&sprites](int a, int b) {
+            return sprites[a].name < sprites[b].name;
+        });
+
+        qint64 used = 0;
+        for (int index : group)
+        {
+            auto & sprite = sprites[index];
+            pages[index] = firstPage + int(used / (PAGE_SIZE * PAGE_SIZE));
+            used += qint64(qMax(1, sprite.frames))
+                    * (sprite.size.width() + 2 * PAGE_PADDING)
+                    * (sprite.size.height() + 2 * PAGE_PADDING);
+        }
+        firstPage += int(used / (PAGE_SIZE * PAGE_SIZE)) + 1;
+    }
+    return pages;
+}
+
+RoomAnalysis::Report RoomAnalysis::analyze(const Snapshot & snapshot)
+{
+    Report report;
+    report.roomName = snapshot.roomName;
+    report.cellSize = CELL_SIZE;
+
+    auto pages = texturePages(snapshot.sprites);
+
+    // the layers are drawn from the deepest, like GraphicsLayer::sort
+    QVector<const Snapshot::Layer*> layers;
+    for (auto & layer : snapshot.layers)
+    {
+        layers.append(&layer);
+    }
+    std::sort(layers.begin(), layers.end(), [](const Snapshot::Layer * a, const Snapshot::Layer * b) {
+        if (a->depth != b->depth)
+            return a->depth > b->depth;
+        return a->order > b->order;
+    });
+
+    // a batch ends with each layer and each change of texture page
+    QSet<int> usedSprites;
+    QSet<int> usedPages;
+    int currentPage = -1;
+    auto draw = [&](int sprite, bool & layerStarted) {
+        int page = pages[sprite];
+        usedSprites.insert(sprite);
+        usedPages.insert(page);
+        if (page != currentPage)
+        {
+            if (currentPage != -1)
+                report.textureSwaps++;
+            currentPage = page;
+            report.drawBatches++;
+        }
+        else if (!layerStarted)
+        {
+            report.drawBatches++;
+        }
+        layerStarted = true;
+    };
+
+    QVector<int> objectCounts(snapshot.objects.size(), 0);
+    for (auto & layer : layers)
+    {
+        bool layerStarted = false;
+        if (layer->sprite != -1)
+            draw(layer->sprite, layerStarted);
+
+        for (auto & instance : layer->instances)
+        {
+            report.instanceCount++;
+            objectCounts[instance.object]++;
+
+            auto & object = snapshot.objects[instance.object];
+            if (object.visible && object.sprite != -1)
+            {
+                report.drawnInstances++;
+                draw(object.sprite, layerStarted);
+            }
+        }
+    }
+    report.uniqueSprites = usedSprites.size();
+    report.texturePages = usedPages.size();
+
+    for (int i = 0; i < objectCounts.size(); i++)
+    {
+        if (objectCounts[i] > 0)
+            report.instancesPerObject.append({ snapshot.objects[i].name, objectCounts[i] });
+    }
+    std::sort(report.instancesPerObject.begin(), report.instancesPerObject.end(), [](const QPair<QString, int> & a, const QPair<QString, int> & b) {
+        return a.second > b.second;
+    });
+
+    // the instances are counted in the cell of their position, and their
+    // collision masks in every cell they touch, each pair of masks in a
+    // cell has to be checked
+    int columns = qMax(1, (snapshot.roomSize.width() + CELL_SIZE - 1) / CELL_SIZE);
+    int rows = qMax(1, (snapshot.roomSize.height() + CELL_SIZE - 1) / CELL_SIZE);
+    QVector<int> instanceCells(columns * rows, 0);
+    QVector<int> maskCells(columns * rows, 0);
+    auto cellOf = [](int coordinate, int count) {
+        return qBound(0, coordinate >= 0 ? coordinate / CELL_SIZE : -1, count - 1);
+    };
+    for (auto & layer : snapshot.layers)
+    {
+        for (auto & instance : layer.instances)
+        {
+            auto & position = instance.position;
+            bool inside = position.x() >= 0 && position.y() >= 0
+                    && position.x() < columns * CELL_SIZE && position.y() < rows * CELL_SIZE;
+            if (inside)
+                instanceCells[position.y() / CELL_SIZE * columns + position.x() / CELL_SIZE]++;
+
+            auto & object = snapshot.objects[instance.object];
+            int mask = object.mask != -1 ? object.mask : object.sprite;
+            if (mask == -1)
+                continue;
+
+            auto & sprite = snapshot.sprites[mask];
+            auto box = sprite.boundingBox.translated(position - sprite.origin);
+            if (box.right() < 0 || box.bottom() < 0 || box.left() >= columns * CELL_SIZE || box.top() >= rows * CELL_SIZE)
+                continue;
+
+            int left = cellOf(box.left(), columns);
+            int right = cellOf(box.right(), columns);
+            int top = cellOf(box.top(), rows);
+            int bottom = cellOf(box.bottom(), rows);
+            for (int y = top; y <= bottom; y++)
+            {
+                for (int x = left; x <= right; x++)
+                {
+                    maskCells[y * columns + x]++;
+                }
+            }
+        }
+    }
+
+    QVector<qint64> costs(columns * rows);
+    qint64 maxCost = 0;
+    for (int i = 0; i < costs.size(); i++)
+    {
+        qint64 pairs = qint64(maskCells[i]) * (maskCells[i] - 1) / 2;
+        report.collisionPairs += pairs;
+        costs[i] = instanceCells[i] + pairs;
+        maxCost = qMax(maxCost, costs[i]);
+    }
+
+    QVector<int> cells(costs.size());
+    std::iota(cells.begin(), cells.end(), 0);
+    int hotCount = qMin(HOT_SPOT_COUNT, cells.size());
+    std::partial_sort(cells.begin(), cells.begin() + hotCount, cells.end(), [&costs](int a, int b) {
+        return costs[a] > costs[b];
+    });
+    for (int i = 0; i < hotCount && costs[cells[i]] > 0; i++)
+    {
+        int cell = cells[i];
+        QRect area((cell % columns) * CELL_SIZE, (cell / columns) * CELL_SIZE, CELL_SIZE, CELL_SIZE);
+        report.hotSpots.append({ area, instanceCells[cell], qint64(maskCells[cell]) * (maskCells[cell] - 1) / 2 });
+    }
+
+    // from transparent yellow to opaque red, on a logarithmic scale
+    report.heatmap = QImage(columns, rows, QImage::Format_ARGB32);
+    report.heatmap.fill(Qt::transparent);
+    if (maxCost > 0)
+    {
+        qreal logMax = qLn(1 + maxCost);
+        for (int y = 0; y < rows; y++)
+        {
+            auto line = reinterpret_cast<QRgb*>(report.heatmap.scanLine(y));
+            for (int x = 0; x < columns; x++)
+            {
+                auto cost = costs[y * columns + x];
+                if (cost == 0)
+                    continue;
+
+                qreal heat = qLn(1 + cost) / logMax;
+                line[x] = QColor::fromHsvF((1 - heat) / 6, 1, 1, 0.2 + 0.5 * heat).rgba();
+            }
+        }
+    }
+
+    return report;
+}
@@ -0,0 +1,109 @@
+/*
+    Copyright (C) 2018  Alexander Roper
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef ROOMANALYSIS_H
+#define ROOMANALYSIS_H
+
+#include <QHash>
+#include <QImage>
+#include <QPoint>
+#include <QRect>
+#include <QString>
+#include <QVector>
+
+class RoomResourceItem;
+class ObjectInstance;
+// Estimates what a room costs at runtime from its resources only: draw
+// batches and texture swaps in depth order, texture pages, and collision
+// pairs per cell. The snapshot is taken on the GUI thread, the analysis
+// only uses the snapshot and can run in a worker thread.
+class RoomAnalysis
+{
+public:
+    struct Snapshot
+    {
+        struct Sprite
+        {
+            QString name;
+            QString textureGroup;
+            QSize size;
+            int frames;
+            QPoint origin;
+            QRect boundingBox;
+        };
+        struct Object
+        {
+            QString name;
+            // indexes in the sprites, -1 for none
+            int sprite;
+            int mask;
+            bool visible;
+        };
+        struct Instance
+        {
+            int object;
+            QPoint position;
+        };
+        struct Layer
+        {
+            int depth;
+            int order;
+            // the sprite of a background or of a tileset, -1 for none
+            int sprite;
+            QVector<Instance> instances;
+        };
+
+        QString roomName;
+        QSize roomSize;
+        // all the sprites of the project, they share the texture pages
+        QVector<Sprite> sprites;
+        QVector<Object> objects;
+        QVector<Layer> layers;
+    };
+
+    struct HotSpot
+    {
+        QRect area;
+        int instances;
+        qint64 pairs;
+    };
+
+    struct Report
+    {
+        QString roomName;
+        int instanceCount = 0;
+        int drawnInstances = 0;
+        // the most used objects first
+        QVector<QPair<QString, int>> instancesPerObject;
+        int uniqueSprites = 0;
+        int texturePages = 0;
+        int drawBatches = 0;
+        int textureSwaps = 0;
+        qint64 collisionPairs = 0;
+        int cellSize = 0;
+        // the busiest cells first
+        QVector<HotSpot> hotSpots;
+        // one pixel per cell, transparent where nothing happens
+        QImage heatmap;
+    };
+
+    // positions replace the ones of the instances moved in the editor
+    static Snapshot snapshot(RoomResourceItem * room, const QHash<ObjectInstance*, QPoint> & positions = {});
+    static Report analyze(const Snapshot & snapshot);
+};
+
+#endif // ROOMANALYSIS_H
@@ -0,0 +1,169 @@
+/*
+    Copyright (C) 2018  Alexander Roper
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "roomrenderer.h"
+#include "graphicslayer.h"
+#include "graphicsinstance.h"
+#include "graphicsbackground.h"
+#include "graphicstilechunk.h"
+#include "resources/roomresourceitem.h"
+#include "resources/tilesetresourceitem.h"
+#include "resources/dependencies/roomlayer.h"
+#include "resources/dependencies/backgroundlayer.h"
+#include "resources/dependencies/instancelayer.h"
+#include "resources/dependencies/tilelayer.h"
+#include "utils/pngwriter.h"
+#include <QPainter>
+
+// in bytes, the size of a band of the exported images
+static const int BAND_BYTES = 16 * 1024 * 1024;
+
+RoomRenderer::RoomRenderer(RoomResourceItem * room, const QHash<ObjectInstance*, QPoint> & positions)
+    : m_roomSize { room->width(), room->height() }
+{
+    auto layers = room->layers();
+    for (int i = 0; i < layers.size(); i++)
+    {
+        addLayer(layers[i], i, positions);
+    }
+
+    // in painting order, like the view
+    GraphicsLayer::sort(m_layers);
+}
+
+QSize RoomRenderer::roomSize() const
+{
+    return m_roomSize;
+}
+
+QImage RoomRenderer::render(const QRectF & region, qreal scale) const
+{
+    QImage image((region.size() * scale).toSize().expandedTo(QSize(1, 1)), QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+
+    QPainter painter(&image);
+    painter.scale(scale, scale);
+    painter.translate(-region.topLeft());
+    render(&painter, region);
+    painter.end();
+
+    return image;
+}
+
+QImage RoomRenderer::render(qreal scale) const
+{
+    return render(QRectF(QPointF(0, 0), m_roomSize), scale);
+}
+
+void RoomRenderer::render(QPainter * painter, const QRectF & region) const
+{
+    painter->save();
+    painter->setPen(Qt::NoPen);
+    painter->setBrush(Qt::white);
+    painter->drawRect(QRectF(QPointF(0, 0), m_roomSize) & region);
+    painter->restore();
+
+    for (auto & layer : m_layers)
+    {
+        layer->paintCached(painter, region);
+    }
+}
+
+bool RoomRenderer::exportPng(QIODevice * device, qreal scale, std::function<bool(int, int)> progress) const
+{
+    QSize size = (QSizeF(m_roomSize) * scale).toSize();
+    PngWriter writer(device, size);
+    if (scale <= 0 || !writer.begin())
+        return false;
+
+    // the bands are small enough to have one per core in memory
+    int bandHeight = qBound(1, BAND_BYTES / (size.width() * 4), size.height());
+    for (int y = 0; y < size.height(); y += bandHeight)
+    {
+        int rows = qMin(bandHeight, size.height() - y);
+        QImage band(size.width(), rows, QImage::Format_ARGB32_Premultiplied);
+        band.fill(Qt::transparent);
+
+        // painted here, the sprites are pixmaps of this thread
+        QPainter painter(&band);
+        painter.scale(scale, scale);
+        painter.translate(0, -y / scale);
+        render(&painter, QRectF(0, y / scale, size.width() / scale, rows / scale));
+        painter.end();
+
+        writer.writeBand(band);
+        if (writer.hasError() || (progress && !progress(y + rows, size.height())))
+            return false;
+    }
+
+    return writer.end();
+}
+
+void RoomRenderer::addLayer(RoomLayer * layer, int order, const QHash<ObjectInstance*, QPoint> & positions)
+{
+    GraphicsLayer * gLayer = new GraphicsLayer;
+    gLayer->setDepth(layer->depth(), order);
+    m_scene.addItem(gLayer);
+    QRectF roomRect(QPointF(0, 0), m_roomSize);
+
+    if (layer->type() == RoomLayer::Type::Background)
+    {
+        auto bgLayer = qobject_cast<BackgroundLayer*>(layer);
+        if (bgLayer->sprite())
+        {
+            auto bgItem = new GraphicsBackground(bgLayer, roomRect.size());
+            gLayer->addItem(bgItem);
+        }
+        else
+        {
+            auto bgColor = m_scene.addRect(roomRect, QPen(), QBrush(bgLayer->colour()));
+            gLayer->addItem(bgColor);
+        }
+    }
+    else if (layer->type() == RoomLayer::Type::Tiles)
+    {
+        auto tileLayer = qobject_cast<TileLayer*>(layer);
+        for (auto & chunk : tileLayer->chunks())
+        {
+            auto chunkItem = new GraphicsTileChunk(tileLayer, chunk);
+            gLayer->addItem(chunkItem);
+        }
+    }
+    else if (layer->type() == RoomLayer::Type::Instances)
+    {
+        auto instLayer = qobject_cast<InstanceLayer*>(layer);
+        for (auto & instance : instLayer->instances())
+        {
+            auto instItem = new GraphicsInstance(instance);
+            auto it = positions.find(instance);
+            if (it != positions.end())
+                instItem->setPos(it.value());
+            gLayer->addInstance(instItem);
+            instItem->updateSprite();
+        }
+    }
+    else
+    {
+        delete gLayer;
+        return;
+    }
+
+    // drawn in full, and only by paintCached
+    gLayer->setCurrent(true);
+    gLayer->setCached(true);
+    m_layers.append(gLayer);
+}
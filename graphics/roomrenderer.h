@@ -0,0 +1,59 @@
+/*
+    Copyright (C) 2018  Alexander Roper
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef ROOMRENDERER_H
+#define ROOMRENDERER_H
+
+#include <QGraphicsScene>
+#include <QHash>
+#include <QImage>
+#include <functional>
+
+class RoomResourceItem;
+class RoomLayer;
+class ObjectInstance;
+class GraphicsLayer;
+class QPainter;
+class QIODevice;
+// draws a room without a view, with the same items as the room editor
+class RoomRenderer
+{
+public:
+    // positions replace the ones of the instances moved in the editor
+    explicit RoomRenderer(RoomResourceItem * room, const QHash<ObjectInstance*, QPoint> & positions = {});
+
+    QSize roomSize() const;
+
+    // the region is in room coordinates, the image is scaled from it
+    QImage render(const QRectF & region, qreal scale = 1) const;
+    QImage render(qreal scale = 1) const;
+    // the painter must already map the room to its device
+    void render(QPainter * painter, const QRectF & region) const;
+
+    // renders the whole room into a PNG band by band, the progress
+    // is given the rows done and returns false to cancel
+    bool exportPng(QIODevice * device, qreal scale, std::function<bool(int, int)> progress = nullptr) const;
+
+private:
+    void addLayer(RoomLayer * layer, int order, const QHash<ObjectInstance*, QPoint> & positions);
+
+    QGraphicsScene m_scene;
+    QList<GraphicsLayer*> m_layers;
+    QSize m_roomSize;
+};
+
+#endif // ROOMRENDERER_H
@@ -0,0 +1,213 @@
+/*
+    Copyright (C) 2018  Alexander Roper
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "spatialgrid.h"
+#include <QtMath>
+#include <algorithm>
+
+SpatialGrid::SpatialGrid(int cellSize)
+    : m_cellSize { cellSize }
+{
+}
+
+void SpatialGrid::insert(QGraphicsItem * item, const QRectF & bounds)
+{
+    remove(item);
+    m_entries.insert(item, { bounds, m_nextOrder++ });
+    addToCells(item, bounds);
+}
+
+void SpatialGrid::update(QGraphicsItem * item, const QRectF & bounds)
+{
+    auto it = m_entries.find(item);
+    if (it == m_entries.end())
+    {
+        insert(item, bounds);
+        return;
+    }
+
+    auto oldBounds = it->bounds;
+    it->bounds = bounds;
+    if (cells(oldBounds) == cells(bounds))
+    {
+        // still in the same cells
+        return;
+    }
+
+    removeFromCells(item, oldBounds);
+    addToCells(item, bounds);
+}
+
+void SpatialGrid::remove(QGraphicsItem * item)
+{
+    auto it = m_entries.find(item);
+    if (it == m_entries.end())
+        return;
+
+    removeFromCells(item, it->bounds);
+    m_entries.erase(it);
+}
+
+void SpatialGrid::clear()
+{
+    m_cells.clear();
+    m_entries.clear();
+}
+
+QRectF SpatialGrid::bounds(QGraphicsItem * item) const
+{
+    return m_entries.value(item).bounds;
+}
+
+QVector<QGraphicsItem*> SpatialGrid::items(const QRectF & rect) const
+{
+    QVector<QGraphicsItem*> result;
+
+    auto range = cells(rect);
+    if (qint64(range.width()) * range.height() > m_cells.size())
+    {
+        // the rect covers more cells than there are, faster to test everything
+        for (auto it = m_entries.cbegin(); it != m_entries.cend(); ++it)
+        {
+            if (it->bounds.intersects(rect))
+                result.append(it.key());
+        }
+        return result;
+    }
+
+    for (int y = range.top(); y <= range.bottom(); y++)
+    {
+        for (int x = range.left(); x <= range.right(); x++)
+        {
+            auto cell = m_cells.find(key(x, y));
+            if (cell == m_cells.end())
+                continue;
+
+            for (auto & item : *cell)
+            {
+                auto bounds = m_entries.value(item).bounds;
+                // an item spanning several cells is only reported by the first
+                // of its cells inside the range
+                auto itemRange = cells(bounds);
+                if (qMax(itemRange.left(), range.left()) != x || qMax(itemRange.top(), range.top()) != y)
+                    continue;
+
+                if (bounds.intersects(rect))
+                    result.append(item);
+            }
+        }
+    }
+    return result;
+}
+
+QVector<QGraphicsItem*> SpatialGrid::items(const QPointF & point) const
+{
+    QVector<QGraphicsItem*> result;
+
+    auto range = cells(QRectF(point, QSizeF()));
+    auto cell = m_cells.find(key(range.left(), range.top()));
+    if (cell == m_cells.end())
+        return result;
+
+    for (auto & item : *cell)
+    {
+        if (m_entries.value(item).bounds.contains(point))
+            result.append(item);
+    }
+    return result;
+}
+
+bool SpatialGrid::intersects(const QRectF & rect) const
+{
+    auto range = cells(rect);
+    if (qint64(range.width()) * range.height() > m_cells.size())
+    {
+        for (auto it = m_entries.cbegin(); it != m_entries.cend(); ++it)
+        {
+            if (it->bounds.intersects(rect))
+                return true;
+        }
+        return false;
+    }
+
+    for (int y = range.top(); y <= range.bottom(); y++)
+    {
+        for (int x = range.left(); x <= range.right(); x++)
+        {
+            auto cell = m_cells.find(key(x, y));
+            if (cell == m_cells.end())
+                continue;
+
+            for (auto & item : *cell)
+            {
+                if (m_entries.value(item).bounds.intersects(rect))
+                    return true;
+            }
+        }
+    }
+    return false;
+}
+
+QVector<QGraphicsItem*> SpatialGrid::orderedItems(const QRectF & rect) const
+{
+    auto result = items(rect);
+    std::sort(result.begin(), result.end(), [this](QGraphicsItem * a, QGraphicsItem * b) {
+        return m_entries.value(a).order < m_entries.value(b).order;
+    });
+    return result;
+}
+
+QRect SpatialGrid::cells(const QRectF & bounds) const
+{
+    return QRect(QPoint(qFloor(bounds.left() / m_cellSize), qFloor(bounds.top() / m_cellSize)),
+                 QPoint(qFloor(bounds.right() / m_cellSize), qFloor(bounds.bottom() / m_cellSize)));
+}
+
+void SpatialGrid::addToCells(QGraphicsItem * item, const QRectF & bounds)
+{
+    auto range = cells(bounds);
+    for (int y = range.top(); y <= range.bottom(); y++)
+    {
+        for (int x = range.left(); x <= range.right(); x++)
+        {
+            m_cells[key(x, y)].append(item);
+        }
+    }
+}
+
+void SpatialGrid::removeFromCells(QGraphicsItem * item, const QRectF & bounds)
+{
+    auto range = cells(bounds);
+    for (int y = range.top(); y <= range.bottom(); y++)
+    {
+        for (int x = range.left(); x <= range.right(); x++)
+        {
+            auto cell = m_cells.find(key(x, y));
+            if (cell == m_cells.end())
+                continue;
+
+            cell->removeOne(item);
+            if (cell->isEmpty())
+                m_cells.erase(cell);
+        }
+    }
+}
+
+quint64 SpatialGrid::key(int x, int y)
+{
+    return (quint64(quint32(x)) << 32) | quint32(y);
+}
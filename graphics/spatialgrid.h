@@ -0,0 +1,67 @@
+/*
+    Copyright (C) 2018  Alexander Roper
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SPATIALGRID_H
+#define SPATIALGRID_H
+
+#include <QHash>
+#include <QRectF>
+#include <QVector>
+
+class QGraphicsItem;
+
+// Uniform grid over item bounds, for finding items in an area
+// without going through all of them
+class SpatialGrid
+{
+public:
+    explicit SpatialGrid(int cellSize = 128);
+
+    void insert(QGraphicsItem * item, const QRectF & bounds);
+    void update(QGraphicsItem * item, const QRectF & bounds);
+    void remove(QGraphicsItem * item);
+    void clear();
+
+    QRectF bounds(QGraphicsItem * item) const;
+
+    // each item is returned once, in no particular order
+    QVector<QGraphicsItem*> items(const QRectF & rect) const;
+    QVector<QGraphicsItem*> items(const QPointF & point) const;
+    // in the order they were inserted, for painting
+    QVector<QGraphicsItem*> orderedItems(const QRectF & rect) const;
+    // stops at the first item found
+    bool intersects(const QRectF & rect) const;
+
+private:
+    struct Entry
+    {
+        QRectF bounds;
+        quint64 order;
+    };
+
+    QRect cells(const QRectF & bounds) const;
+    void addToCells(QGraphicsItem * item, const QRectF & bounds);
+    void removeFromCells(QGraphicsItem * item, const QRectF & bounds);
+    static quint64 key(int x, int y);
+
+    int m_cellSize;
+    quint64 m_nextOrder = 0;
+    QHash<quint64, QVector<QGraphicsItem*>> m_cells;
+    QHash<QGraphicsItem*, Entry> m_entries;
+};
+
+#endif // SPATIALGRID_H
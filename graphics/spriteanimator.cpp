@@ -0,0 +1,131 @@
+/*
+    Copyright (C) 2018  Alexander Roper
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "spriteanimator.h"
+#include "resources/spriteresourceitem.h"
+#include <QFutureWatcher>
+#include <QImage>
+#include <QtConcurrent>
+#include <QtMath>
+
+// in milliseconds, 60 ticks per second
+static const int TICK_INTERVAL = 16;
+
+SpriteAnimator * SpriteAnimator::instance()
+{
+    static SpriteAnimator animator;
+    return &animator;
+}
+
+SpriteAnimator::SpriteAnimator()
+{
+    m_timer.setInterval(TICK_INTERVAL);
+    connect(&m_timer, &QTimer::timeout, this, &SpriteAnimator::tick);
+    m_clock.start();
+}
+
+int SpriteAnimator::frame(const SpriteResourceItem * sprite) const
+{
+    if (sprite == nullptr || sprite->frameCount() < 2 || sprite->framesPerSecond() <= 0)
+        return 0;
+
+    qint64 frame = qFloor(m_clock.elapsed() * sprite->framesPerSecond() / 1000);
+    return int(frame % sprite->frameCount());
+}
+
+QPixmap SpriteAnimator::framePixmap(const SpriteResourceItem * sprite, int frame)
+{
+    // a single frame is left to SpriteCache
+    if (sprite == nullptr || sprite->frameCount() < 2 || frame < 0 || frame >= sprite->frameCount())
+        return QPixmap();
+
+    auto it = m_frames.constFind(sprite);
+    if (it == m_frames.constEnd())
+    {
+        decodeFrames(sprite);
+        return QPixmap();
+    }
+    return it->value(frame);
+}
+
+void SpriteAnimator::decodeFrames(const SpriteResourceItem * sprite)
+{
+    if (m_decoding.contains(sprite))
+        return;
+    m_decoding.insert(sprite);
+
+    // only the paths are given to the thread, the resources stay in this one
+    QStringList paths;
+    for (int frame = 0; frame < sprite->frameCount(); ++frame)
+    {
+        paths.append(sprite->framePath(frame));
+    }
+
+    int generation = m_generation;
+    auto watcher = new QFutureWatcher<QVector<QImage>>(this);
+    connect(watcher, &QFutureWatcher<QVector<QImage>>::finished, this, [this, watcher, sprite, generation]() {
+        watcher->deleteLater();
+        if (generation != m_generation)
+            return;
+
+        m_decoding.remove(sprite);
+        // converted in this thread, QPixmap can't be used in the others
+        QVector<QPixmap> frames;
+        for (auto & image : watcher->result())
+        {
+            frames.append(QPixmap::fromImage(image));
+        }
+        m_frames.insert(sprite, frames);
+        emit framesReady(sprite);
+    });
+    watcher->setFuture(QtConcurrent::run([paths]() {
+        QVector<QImage> images;
+        for (auto & path : paths)
+        {
+            images.append(QImage(path));
+        }
+        return images;
+    }));
+}
+
+void SpriteAnimator::addClient(QObject * client)
+{
+    if (m_clients.contains(client))
+        return;
+
+    m_clients.insert(client);
+    connect(client, &QObject::destroyed, this, &SpriteAnimator::removeClient);
+    if (!m_timer.isActive())
+        m_timer.start();
+}
+
+void SpriteAnimator::removeClient(QObject * client)
+{
+    if (!m_clients.remove(client))
+        return;
+
+    disconnect(client, &QObject::destroyed, this, &SpriteAnimator::removeClient);
+    disconnect(this, &SpriteAnimator::tick, client, nullptr);
+    if (m_clients.isEmpty())
+    {
+        m_timer.stop();
+        // decoded again when an animation plays, the sprites may have changed
+        m_frames.clear();
+        m_decoding.clear();
+        ++m_generation;
+    }
+}
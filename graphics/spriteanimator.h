@@ -0,0 +1,68 @@
+/*
+    Copyright (C) 2018  Alexander Roper
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SPRITEANIMATOR_H
+#define SPRITEANIMATOR_H
+
+#include <QObject>
+#include <QHash>
+#include <QPixmap>
+#include <QSet>
+#include <QTimer>
+#include <QElapsedTimer>
+
+class SpriteResourceItem;
+// The single timer of the sprite animations. The frame of a sprite only
+// depends on the time, so everything showing it is in sync, and the
+// clients only have to draw again what they show on each tick.
+// The frames of the animated sprites are decoded once, in a worker thread,
+// and kept while the animations play, so a tick only swaps pixmaps.
+class SpriteAnimator : public QObject
+{
+    Q_OBJECT
+
+public:
+    static SpriteAnimator * instance();
+
+    int frame(const SpriteResourceItem * sprite) const;
+
+    // null until all the frames of the sprite are decoded, see framesReady
+    QPixmap framePixmap(const SpriteResourceItem * sprite, int frame);
+
+    // the timer only runs while there are clients
+    void addClient(QObject * client);
+    void removeClient(QObject * client);
+
+signals:
+    void tick();
+    void framesReady(const SpriteResourceItem * sprite);
+
+private:
+    SpriteAnimator();
+
+    void decodeFrames(const SpriteResourceItem * sprite);
+
+    QTimer m_timer;
+    QElapsedTimer m_clock;
+    QSet<QObject*> m_clients;
+    QHash<const SpriteResourceItem*, QVector<QPixmap>> m_frames;
+    QSet<const SpriteResourceItem*> m_decoding;
+    // the frames decoded for the clients which are gone are dropped
+    int m_generation = 0;
+};
+
+#endif // SPRITEANIMATOR_H
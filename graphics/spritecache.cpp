@@ -0,0 +1,77 @@
+/*
+    Copyright (C) 2018  Alexander Roper
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "spritecache.h"
+#include "resources/spriteresourceitem.h"
+#include <QPixmapCache>
+
+// in kilobytes, the default limit of QPixmapCache is too small for rooms
+static const int CACHE_LIMIT = 64 * 1024;
+
+QPixmap SpriteCache::pixmap(const SpriteResourceItem * sprite, int frame, qreal scale)
+{
+    if (sprite == nullptr || frame < 0 || frame >= sprite->frameCount() || scale <= 0)
+        return QPixmap();
+
+    if (QPixmapCache::cacheLimit() < CACHE_LIMIT)
+        QPixmapCache::setCacheLimit(CACHE_LIMIT);
+
+    QPixmap pix;
+    auto pixKey = key(sprite, frame, scale);
+    if (QPixmapCache::find(pixKey, &pix))
+        return pix;
+
+    if (qFuzzyCompare(scale, qreal(1)))
+    {
+        pix = QPixmap(sprite->framePath(frame));
+    }
+    else
+    {
+        // scaled from the original frame, so it's only decoded once
+        pix = pixmap(sprite, frame);
+        if (!pix.isNull())
+        {
+            pix = pix.scaled(pix.size() * scale, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+        }
+    }
+
+    if (!pix.isNull())
+        QPixmapCache::insert(pixKey, pix);
+    return pix;
+}
+
+bool SpriteCache::find(const SpriteResourceItem * sprite, int frame, QPixmap * pixmap)
+{
+    if (sprite == nullptr)
+        return false;
+    return QPixmapCache::find(key(sprite, frame, 1), pixmap);
+}
+
+void SpriteCache::insert(const SpriteResourceItem * sprite, int frame, const QPixmap & pixmap)
+{
+    if (sprite == nullptr || pixmap.isNull())
+        return;
+
+    if (QPixmapCache::cacheLimit() < CACHE_LIMIT)
+        QPixmapCache::setCacheLimit(CACHE_LIMIT);
+    QPixmapCache::insert(key(sprite, frame, 1), pixmap);
+}
+
+QString SpriteCache::key(const SpriteResourceItem * sprite, int frame, qreal scale)
+{
+    return QString("sprite:%1:%2:%3").arg(sprite->id()).arg(frame).arg(scale);
+}
@@ -0,0 +1,40 @@
+/*
+    Copyright (C) 2018  Alexander Roper
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SPRITECACHE_H
+#define SPRITECACHE_H
+
+#include <QPixmap>
+
+class SpriteResourceItem;
+
+// Decoded sprite frames shared by everything drawing them.
+// The cache is bounded, evicted frames are decoded again when needed.
+class SpriteCache
+{
+public:
+    static QPixmap pixmap(const SpriteResourceItem * sprite, int frame = 0, qreal scale = 1);
+
+    // without decoding, for frames decoded elsewhere (see RoomEditor::reset)
+    static bool find(const SpriteResourceItem * sprite, int frame, QPixmap * pixmap);
+    static void insert(const SpriteResourceItem * sprite, int frame, const QPixmap & pixmap);
+
+private:
+    static QString key(const SpriteResourceItem * sprite, int frame, qreal scale);
+};
+
+#endif // SPRITECACHE_H
@@ -25,6 +25,7 @@
 #include <QLabel>
 #include "resources/allresourceitems.h"
 #include "editors/alleditors.h"
+#include "widgets/spritepreview.h"
 #include <QMessageBox>
 
 MainWindow::MainWindow(QWidget *parent) :
@@ -36,6 +37,7 @@ MainWindow::MainWindow(QWidget *parent) :
     // DOCKS
     resourcesTreeDock.setModel(&resourcesModel);
     addDockWidget(Qt::RightDockWidgetArea, &resourcesTreeDock);
+    addDockWidget(Qt::RightDockWidgetArea, &minimapDock);
 
     // CENTRAL WIDGET
     tabWidget = new QTabWidget;
@@ -59,8 +61,11 @@ MainWindow::MainWindow(QWidget *parent) :
     connect(&resourcesTreeDock, &ResourcesTreeDock::openSprite, this, &MainWindow::openSprite);
     connect(&resourcesTreeDock, &ResourcesTreeDock::openWindowsOptions, this, &MainWindow::openWindowsOptions);
     connect(&resourcesTreeDock, &ResourcesTreeDock::visibilityChanged, ui->action_Resources, &QAction::setChecked);
+    connect(ui->action_Minimap, &QAction::toggled, &minimapDock, &MinimapDock::setVisible);
+    connect(&minimapDock, &MinimapDock::visibilityChanged, ui->action_Minimap, &QAction::setChecked);
 
     connect(tabWidget, &QTabWidget::tabCloseRequested, this, &MainWindow::closeTab);
+    connect(tabWidget, &QTabWidget::currentChanged, this, &MainWindow::updateMinimap);
 
     auto lop = GameSettings::lastOpenedProject();
     if (!lop.isEmpty())
@@ -103,6 +108,16 @@ void MainWindow::openRoom(RoomResourceItem * item)
 
     connect(editor, &RoomEditor::openObject, this, &MainWindow::openObject);
     connect(editor, &RoomEditor::openInstance, this, &MainWindow::openInstance);
+    connect(editor, &RoomEditor::showRoomInstance, this, &MainWindow::showRoomInstance);
+}
+
+void MainWindow::showRoomInstance(RoomResourceItem * room, ObjectInstance * instance)
+{
+    openRoom(room);
+    if (auto editor = qobject_cast<RoomEditor*>(tabWidget->currentWidget()))
+    {
+        editor->showInstance(instance);
+    }
 }
 
 void MainWindow::openSprite(SpriteResourceItem * item)
@@ -113,7 +128,7 @@ void MainWindow::openSprite(SpriteResourceItem * item)
         return;
     }
 
-    int pos = tabWidget->addTab(new QLabel("sprite"), item->name());
+    int pos = tabWidget->addTab(new SpritePreview(item), item->name());
 
     idOfOpenedTabs.push_back(id);
 
@@ -134,6 +149,8 @@ void MainWindow::openScript(ScriptResourceItem * item)
     idOfOpenedTabs.push_back(id);
 
     tabWidget->setCurrentIndex(pos);
+
+    connectEditors(editor, item);
 }
 
 void MainWindow::openAndroidOptions(AndroidOptionsResourceItem * item)
@@ -341,6 +358,7 @@ bool MainWindow::closeProject()
     }
 
     // clear everything
+    editJournal.close();
     ResourceItem::clear();
     resourcesModel.clear();
     tabWidget->clear();
@@ -359,6 +377,12 @@ void MainWindow::updateChildren(ObjectResourceItem * item)
     }
 }
 
+void MainWindow::updateMinimap()
+{
+    auto roomEditor = qobject_cast<RoomEditor*>(tabWidget->currentWidget());
+    minimapDock.setView(roomEditor ? roomEditor->roomView() : nullptr);
+}
+
 void MainWindow::loadProject(QString filename)
 {
     if (!closeProject())
@@ -381,6 +405,9 @@ void MainWindow::loadProject(QString filename)
     resourcesModel.fill(ResourceItem::all());
 
     GameSettings::setLastOpenedProject(filename);
+
+    editJournal.open(GameSettings::rootPath() + "/.gmlinux/journal");
+    recoverJournal();
 }
 
 bool MainWindow::moveToTab(QString id)
@@ -397,7 +424,8 @@ bool MainWindow::moveToTab(QString id)
 
 bool MainWindow::closeTab(int pos)
 {
-    auto editor = qobject_cast<MainEditor*>(tabWidget->widget(pos));
+    auto widget = tabWidget->widget(pos);
+    auto editor = qobject_cast<MainEditor*>(widget);
     if (editor && editor->isDirty())
     {
         auto btn = QMessageBox::warning(this, "Unsaved changes", "You have unsaved changes, do you really want to close this editor?", QMessageBox::Yes, QMessageBox::No);
@@ -405,10 +433,17 @@ bool MainWindow::closeTab(int pos)
         {
             return false;
         }
+
+        // the resource is left as it is in its file, and the
+        // discarded edits are not recovered after a crash
+        editor->discardChanges();
+        editJournal.markSaved(idOfOpenedTabs[pos]);
     }
 
     idOfOpenedTabs.remove(pos);
     tabWidget->removeTab(pos);
+    // a closed editor is not saved with the project anymore
+    widget->deleteLater();
 
     return true;
 }
@@ -421,6 +456,64 @@ void MainWindow::connectEditors(MainEditor * editor, ResourceItem* item)
     });
     connect(this, &MainWindow::doSave, editor, &MainEditor::save);
     connect(editor, &MainEditor::saved, this, &MainWindow::saveProjectItem);
+
+    auto id = item->id();
+    connect(editor, &MainEditor::journalEntry, &editJournal, [this, id](QJsonObject entry) {
+        editJournal.append(id, entry);
+    });
+    connect(editor, &MainEditor::saved, &editJournal, [this, id]() {
+        editJournal.markSaved(id);
+    });
+}
+
+void MainWindow::recoverJournal()
+{
+    auto entries = editJournal.recoveredEntries();
+    editJournal.clearRecoveredEntries();
+    if (entries.isEmpty())
+    {
+        return;
+    }
+
+    auto choice = QMessageBox::question(this, "Unsaved changes", "The project was not closed properly. Do you want to recover the unsaved changes?", QMessageBox::Yes, QMessageBox::No);
+    if (choice == QMessageBox::No)
+    {
+        return;
+    }
+
+    for (auto it = entries.begin(); it != entries.end(); ++it)
+    {
+        auto pItem = ResourceItem::get(it.key());
+        if (pItem == nullptr)
+        {
+            continue;
+        }
+
+        switch (pItem->type())
+        {
+        case ResourceType::Object:
+            openObject(qobject_cast<ObjectResourceItem*>(pItem));
+            break;
+        case ResourceType::Room:
+            openRoom(qobject_cast<RoomResourceItem*>(pItem));
+            break;
+        case ResourceType::Script:
+            openScript(qobject_cast<ScriptResourceItem*>(pItem));
+            break;
+        default:
+            qCritical() << "Can't recover changes of:" << Utils::resourceTypeToString(pItem->type());
+            continue;
+        }
+
+        auto editor = qobject_cast<MainEditor*>(tabWidget->widget(idOfOpenedTabs.indexOf(pItem->id())));
+        if (editor)
+        {
+            for (auto & entry : it.value())
+            {
+                editor->replay(entry);
+            }
+        }
+    }
 }
 
 void MainWindow::closeEvent(QCloseEvent * event)
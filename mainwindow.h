@@ -24,6 +24,8 @@
 #include "resources/projectresource.h"
 #include "models/resourcesmodel.h"
 #include "docks/resourcestreedock.h"
+#include "docks/minimapdock.h"
+#include "utils/editjournal.h"
 
 namespace Ui {
 class MainWindow;
@@ -44,6 +46,7 @@ signals:
 private slots:
     void openProject();
     void openRoom(RoomResourceItem* item);
+    void showRoomInstance(RoomResourceItem* room, ObjectInstance* instance);
     void openSprite(SpriteResourceItem* item);
     void openScript(ScriptResourceItem* item);
     void openAndroidOptions(AndroidOptionsResourceItem* item);
@@ -62,6 +65,7 @@ private slots:
     bool closeProject();
 
     void updateChildren(ObjectResourceItem* item);
+    void updateMinimap();
 
 protected:
     void closeEvent(QCloseEvent * event) override;
@@ -71,11 +75,14 @@ private:
     bool moveToTab(QString id);
     bool closeTab(int pos);
     void connectEditors(MainEditor* editor, ResourceItem * item);
+    void recoverJournal();
 
     Ui::MainWindow * ui;
     ResourcesModel resourcesModel;
     ProjectResource projectResource;
     ResourcesTreeDock resourcesTreeDock;
+    MinimapDock minimapDock;
+    EditJournal editJournal;
     QTabWidget * tabWidget;
     QVector<QString> idOfOpenedTabs;
     bool m_savingProject = false;
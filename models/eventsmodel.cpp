@@ -132,6 +132,23 @@ void EventsModel::setModified(int row, bool modified)
     emit dataChanged(index(row), index(row), { Qt::DisplayRole });
 }
 
+bool EventsModel::isModified(int row) const
+{
+    return items[row].modified;
+}
+
+bool EventsModel::hasModifiedEvents() const
+{
+    for (auto & eventItem : items)
+    {
+        if (eventItem.modified)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
 bool EventsModel::isInherited(int row) const
 {
     return items[row].inherited;
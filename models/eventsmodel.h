@@ -44,6 +44,8 @@ public:
 
     QString getFilename(int row) const;
     void setModified(int row, bool modified);
+    bool isModified(int row) const;
+    bool hasModifiedEvents() const;
     bool isInherited(int row) const;
     ObjectEvent * event(int row) const;
 
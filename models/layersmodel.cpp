@@ -77,6 +77,19 @@ RoomLayer * LayersModel::layer(int row) const
     return items[row].layer;
 }
 
+void LayersModel::setLayerVisible(QString id, bool visible)
+{
+    for (int i = 0; i < items.size(); i++)
+    {
+        if (items[i].layer->id() == id)
+        {
+            items[i].visible = visible ? Qt::Checked : Qt::Unchecked;
+            emit dataChanged(index(i), index(i), { Qt::CheckStateRole });
+            return;
+        }
+    }
+}
+
 void LayersModel::clear()
 {
     beginResetModel();
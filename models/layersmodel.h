@@ -43,6 +43,8 @@ public:
 
     void addLayer(RoomLayer * layer);
     RoomLayer * layer(int row) const;
+    // doesn't emit visibilityChanged
+    void setLayerVisible(QString id, bool visible);
 
     void clear();
 
@@ -18,6 +18,9 @@
 #include "objectsmodel.h"
 #include "resources/dependencies/objectinstance.h"
 
+// rows given to the view at once
+static const int FETCH_SIZE = 1000;
+
 ObjectsModel::ObjectsModel(QObject *parent)
     : QAbstractListModel { parent }
 {
@@ -28,7 +31,7 @@ int ObjectsModel::rowCount(const QModelIndex &parent) const
     if (parent.isValid())
         return 0;
 
-    return items.size();
+    return loadedRows;
 }
 
 QVariant ObjectsModel::data(const QModelIndex &index, int role) const
@@ -36,13 +39,12 @@ QVariant ObjectsModel::data(const QModelIndex &index, int role) const
     if (!index.isValid())
         return QVariant();
 
-    auto & item = items[index.row()];
     switch (role)
     {
     case Qt::DisplayRole:
-        return item.object->name();
+        return instances[index.row()]->name();
     case Qt::CheckStateRole:
-        return item.visible;
+        return visible.testBit(index.row()) ? Qt::Checked : Qt::Unchecked;
     }
 
     return QVariant();
@@ -61,55 +63,104 @@ bool ObjectsModel::setData(const QModelIndex & index, const QVariant & value, in
         switch (role)
         {
         case Qt::CheckStateRole:
-            items[index.row()].visible = value.value<Qt::CheckState>();
+        {
+            bool checked = value.value<Qt::CheckState>() == Qt::Checked;
+            visible.setBit(index.row(), checked);
 
-            visibilityChanged(items[index.row()].object->id(), value.value<Qt::CheckState>() == Qt::Checked);
+            emit dataChanged(index, index, { Qt::CheckStateRole });
+            emit visibilityChanged(instances[index.row()]->id(), checked);
             return true;
         }
+        }
     }
 
     return false;
 }
 
-void ObjectsModel::addObject(ObjectInstance * object)
+bool ObjectsModel::canFetchMore(const QModelIndex & parent) const
+{
+    if (parent.isValid())
+        return false;
+
+    return loadedRows < instances.size();
+}
+
+void ObjectsModel::fetchMore(const QModelIndex & parent)
 {
-    beginInsertRows(QModelIndex(), items.size(), items.size());
-    items.append({ object });
+    if (parent.isValid())
+        return;
+
+    int count = qMin(FETCH_SIZE, instances.size() - loadedRows);
+    if (count <= 0)
+        return;
+
+    beginInsertRows(QModelIndex(), loadedRows, loadedRows + count - 1);
+    loadedRows += count;
     endInsertRows();
 }
 
-int ObjectsModel::rowOf(ObjectInstance * object) const
+void ObjectsModel::setInstances(const QVector<ObjectInstance*> & instances, const QBitArray & visible)
 {
-    int i = 0;
-    for (auto & item : items)
+    beginResetModel();
+    this->instances = instances;
+    this->visible = visible;
+    this->visible.resize(instances.size());
+
+    rows.clear();
+    rows.reserve(instances.size());
+    for (int i = 0; i < instances.size(); i++)
     {
-        if (item.object == object)
-        {
-            return i;
-        }
-        i++;
+        rows.insert(instances[i], i);
     }
-    return -1;
+
+    loadedRows = qMin(FETCH_SIZE, instances.size());
+    endResetModel();
+}
+
+int ObjectsModel::rowOf(ObjectInstance * object) const
+{
+    return rows.value(object, -1);
 }
 
-QModelIndex ObjectsModel::indexOf(ObjectInstance * object) const
+QModelIndex ObjectsModel::indexOf(ObjectInstance * object)
 {
     auto row = rowOf(object);
-    if (row != -1)
-        return index(row);
-    return QModelIndex();
+    if (row == -1)
+        return QModelIndex();
+
+    if (row >= loadedRows)
+    {
+        beginInsertRows(QModelIndex(), loadedRows, row);
+        loadedRows = row + 1;
+        endInsertRows();
+    }
+    return index(row);
 }
 
 ObjectInstance *ObjectsModel::objectInstance(int row) const
 {
-    if (row < items.size())
-        return items[row].object;
+    if (row >= 0 && row < instances.size())
+        return instances[row];
     return nullptr;
 }
 
+void ObjectsModel::setInstanceVisible(ObjectInstance * object, bool visible)
+{
+    auto row = rowOf(object);
+    if (row == -1)
+        return;
+
+    this->visible.setBit(row, visible);
+    if (row < loadedRows)
+        emit dataChanged(index(row), index(row), { Qt::CheckStateRole });
+}
+
 void ObjectsModel::clear()
 {
     beginResetModel();
-    items.clear();
+    instances.clear();
+    visible.clear();
+    rows.clear();
+    loadedRows = 0;
     endResetModel();
 }
@@ -19,15 +19,10 @@
 #define OBJECTSMODEL_H
 
 #include <QAbstractListModel>
+#include <QBitArray>
+#include <QHash>
 
 class ObjectInstance;
-struct ObjectItem
-{
-    ObjectInstance * object;
-    Qt::CheckState visible = Qt::Checked;
-    bool locked = false; // unused
-};
-
 class ObjectsModel : public QAbstractListModel
 {
     Q_OBJECT
@@ -41,10 +36,17 @@ public:
 
     bool setData(const QModelIndex & index, const QVariant & value, int role) override;
 
-    void addObject(ObjectInstance * object);
+    bool canFetchMore(const QModelIndex & parent) const override;
+    void fetchMore(const QModelIndex & parent) override;
+
+    // replaces the content of the model, rows are given to the view as it scrolls
+    void setInstances(const QVector<ObjectInstance*> & instances, const QBitArray & visible);
     int rowOf(ObjectInstance * object) const;
-    QModelIndex indexOf(ObjectInstance * object) const;
+    // loads the rows up to the instance if needed
+    QModelIndex indexOf(ObjectInstance * object);
     ObjectInstance * objectInstance(int row) const;
+    // doesn't emit visibilityChanged
+    void setInstanceVisible(ObjectInstance * object, bool visible);
 
     void clear();
 
@@ -52,7 +54,10 @@ signals:
     void visibilityChanged(QString id, bool visible);
 
 private:
-    QVector<ObjectItem> items;
+    QVector<ObjectInstance*> instances;
+    QBitArray visible;
+    QHash<ObjectInstance*, int> rows;
+    int loadedRows = 0;
 };
 
 #endif // OBJECTSMODEL_H
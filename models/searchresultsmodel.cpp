@@ -0,0 +1,142 @@
+/*
+    Copyright (C) 2018  Alexander Roper
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "searchresultsmodel.h"
+#include "resources/roomresourceitem.h"
+#include "resources/objectresourceitem.h"
+#include "resources/dependencies/objectinstance.h"
+#include "utils/uuid.h"
+
+// rows given to the view at once
+static const int FETCH_SIZE = 1000;
+
+SearchResultsModel::SearchResultsModel(QObject *parent)
+    : QAbstractListModel { parent }
+{
+}
+
+int SearchResultsModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+
+    return loadedRows;
+}
+
+QVariant SearchResultsModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid())
+        return QVariant();
+
+    auto & result = results[index.row()];
+    switch (role)
+    {
+    case Qt::DisplayRole:
+    {
+        auto pInstance = instance(index.row());
+        if (pInstance == nullptr)
+            return QString("<deleted>");
+
+        auto text = pInstance->name();
+        if (auto pObject = pInstance->object())
+            text += QString(" (%1)").arg(pObject->name());
+        auto pRoom = room(index.row());
+        if (showRooms && pRoom)
+            text = QString("%1: %2").arg(pRoom->name(), text);
+        return text;
+    }
+    case Qt::ToolTipRole:
+    {
+        auto position = result.position;
+        return QString("x: %1, y: %2").arg(position.x()).arg(position.y());
+    }
+    }
+
+    return QVariant();
+}
+
+bool SearchResultsModel::canFetchMore(const QModelIndex & parent) const
+{
+    if (parent.isValid())
+        return false;
+
+    return loadedRows < results.size();
+}
+
+void SearchResultsModel::fetchMore(const QModelIndex & parent)
+{
+    if (parent.isValid())
+        return;
+
+    int count = qMin(FETCH_SIZE, results.size() - loadedRows);
+    if (count <= 0)
+        return;
+
+    beginInsertRows(QModelIndex(), loadedRows, loadedRows + count - 1);
+    loadedRows += count;
+    endInsertRows();
+}
+
+void SearchResultsModel::setResults(const QVector<SearchResult> & results, bool showRooms)
+{
+    beginResetModel();
+    this->results = results;
+    this->showRooms = showRooms;
+    loadedRows = qMin(FETCH_SIZE, results.size());
+    endResetModel();
+}
+
+int SearchResultsModel::resultCount() const
+{
+    return results.size();
+}
+
+RoomResourceItem * SearchResultsModel::room(int row) const
+{
+    if (row < 0 || row >= results.size() || Uuid::isNull(results[row].roomId))
+        return nullptr;
+    return ResourceItem::get<RoomResourceItem>(results[row].roomId);
+}
+
+ObjectInstance * SearchResultsModel::instance(int row) const
+{
+    if (row < 0 || row >= results.size() || Uuid::isNull(results[row].instanceId))
+        return nullptr;
+    return ResourceItem::get<ObjectInstance>(results[row].instanceId);
+}
+
+QVector<ObjectInstance*> SearchResultsModel::instancesIn(RoomResourceItem * room) const
+{
+    QVector<ObjectInstance*> instances;
+    for (int row = 0; row < results.size(); row++)
+    {
+        if (results[row].roomId != room->id())
+            continue;
+        if (auto pInstance = instance(row))
+            instances.append(pInstance);
+    }
+    return instances;
+}
+
+void SearchResultsModel::clear()
+{
+    beginResetModel();
+    results.clear();
+    showRooms = false;
+    loadedRows = 0;
+    endResetModel();
+}
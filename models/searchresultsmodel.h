@@ -0,0 +1,67 @@
+/*
+    Copyright (C) 2018  Alexander Roper
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SEARCHRESULTSMODEL_H
+#define SEARCHRESULTSMODEL_H
+
+#include <QAbstractListModel>
+#include <QPoint>
+#include <QString>
+
+class RoomResourceItem;
+class ObjectInstance;
+// the ids are kept, the instances of a room may be deleted and read
+// again while the results are shown
+struct SearchResult
+{
+    QString roomId;
+    QString instanceId;
+    // where the instance was found, it may not be saved yet
+    QPoint position;
+};
+
+class SearchResultsModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    explicit SearchResultsModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    bool canFetchMore(const QModelIndex & parent) const override;
+    void fetchMore(const QModelIndex & parent) override;
+
+    // the rows are given to the view as it scrolls, the rooms are only
+    // named when the results come from several of them
+    void setResults(const QVector<SearchResult> & results, bool showRooms);
+    int resultCount() const;
+    // nullptr when they don't exist anymore
+    RoomResourceItem * room(int row) const;
+    ObjectInstance * instance(int row) const;
+    QVector<ObjectInstance*> instancesIn(RoomResourceItem * room) const;
+
+    void clear();
+
+private:
+    QVector<SearchResult> results;
+    bool showRooms = false;
+    int loadedRows = 0;
+};
+
+#endif // SEARCHRESULTSMODEL_H
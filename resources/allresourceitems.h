@@ -34,8 +34,10 @@
 #include "includedfileresourceitem.h"
 #include "soundresourceitem.h"
 #include "fontresourceitem.h"
+#include "tilesetresourceitem.h"
 #include "dependencies/instancelayer.h"
 #include "dependencies/backgroundlayer.h"
+#include "dependencies/tilelayer.h"
 #include "dependencies/objectinstance.h"
 
 #endif // ALLRESOURCEITEMS_H
@@ -32,12 +32,43 @@ void BackgroundLayer::load(QJsonObject object)
     m_spriteId = object["spriteId"].toString();
 
     auto colourJson = object["colour"].toObject();
+    m_colourJson = colourJson;
     auto colourValue = colourJson["Value"].toVariant().toUInt();
     int r = colourValue & 0xFF;
     int g = (colourValue >> 8) & 0xFF;
     int b = (colourValue >> 16) & 0xFF;
     int a = (colourValue >> 24) & 0xFF;
     m_colour = QColor(r, g, b, a);
+
+    m_htiled = object["htiled"].toBool();
+    m_vtiled = object["vtiled"].toBool();
+    m_stretch = object["stretch"].toBool();
+    m_position = QPointF(object["x"].toDouble(), object["y"].toDouble());
+    m_speed = QPointF(object["hspeed"].toDouble(), object["vspeed"].toDouble());
+}
+
+QJsonObject BackgroundLayer::fields() const
+{
+    QJsonObject object = RoomLayer::fields();
+    object["spriteId"] = m_spriteId;
+
+    uint colourValue = static_cast<uint>(m_colour.red())
+            | static_cast<uint>(m_colour.green()) << 8
+            | static_cast<uint>(m_colour.blue()) << 16
+            | static_cast<uint>(m_colour.alpha()) << 24;
+    QJsonObject colourJson = m_colourJson;
+    colourJson["Value"] = static_cast<qint64>(colourValue);
+    object["colour"] = colourJson;
+
+    object["htiled"] = m_htiled;
+    object["vtiled"] = m_vtiled;
+    object["stretch"] = m_stretch;
+    object["x"] = m_position.x();
+    object["y"] = m_position.y();
+    object["hspeed"] = m_speed.x();
+    object["vspeed"] = m_speed.y();
+
+    return object;
 }
 
 SpriteResourceItem *BackgroundLayer::sprite() const
@@ -53,3 +84,28 @@ QColor BackgroundLayer::colour() const
 {
     return m_colour;
 }
+
+bool BackgroundLayer::isHTiled() const
+{
+    return m_htiled;
+}
+
+bool BackgroundLayer::isVTiled() const
+{
+    return m_vtiled;
+}
+
+bool BackgroundLayer::isStretched() const
+{
+    return m_stretch;
+}
+
+QPointF BackgroundLayer::position() const
+{
+    return m_position;
+}
+
+QPointF BackgroundLayer::speed() const
+{
+    return m_speed;
+}
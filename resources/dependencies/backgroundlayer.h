@@ -20,6 +20,7 @@
 
 #include "roomlayer.h"
 #include <QColor>
+#include <QPointF>
 
 class BackgroundLayer : public RoomLayer
 {
@@ -33,9 +34,24 @@ public:
     SpriteResourceItem * sprite() const;
     QColor colour() const;
 
+    bool isHTiled() const;
+    bool isVTiled() const;
+    bool isStretched() const;
+    QPointF position() const;
+    QPointF speed() const;
+
+protected:
+    QJsonObject fields() const override;
+
 private:
+    QJsonObject m_colourJson;
     QString m_spriteId;
     QColor m_colour = Qt::black;
+    bool m_htiled = false;
+    bool m_vtiled = false;
+    bool m_stretch = false;
+    QPointF m_position;
+    QPointF m_speed;
 };
 
 #endif // BACKGROUNDLAYER_H
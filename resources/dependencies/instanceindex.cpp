@@ -0,0 +1,131 @@
+/*
+    Copyright (C) 2018  Alexander Roper
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "instanceindex.h"
+#include "instancelayer.h"
+#include "objectinstance.h"
+#include <algorithm>
+#include <numeric>
+
+void InstanceIndex::build(const QVector<RoomLayer*> & layers)
+{
+    clear();
+
+    for (auto & layer : layers)
+    {
+        auto instLayer = qobject_cast<InstanceLayer*>(layer);
+        if (instLayer == nullptr)
+            continue;
+
+        for (auto & instance : instLayer->instances())
+        {
+            m_byObject[instance->objectId()].append(m_entries.size());
+            m_rows.insert(instance, m_entries.size());
+            m_entries.append({ instance, instance->name().toCaseFolded(), instance->objectId(), instance->position() });
+        }
+    }
+
+    m_byX.resize(m_entries.size());
+    std::iota(m_byX.begin(), m_byX.end(), 0);
+    std::stable_sort(m_byX.begin(), m_byX.end(), [this](int a, int b) {
+        return m_entries[a].position.x() < m_entries[b].position.x();
+    });
+}
+
+void InstanceIndex::clear()
+{
+    m_entries.clear();
+    m_byObject.clear();
+    m_byX.clear();
+    m_rows.clear();
+}
+
+int InstanceIndex::size() const
+{
+    return m_entries.size();
+}
+
+QVector<ObjectInstance*> InstanceIndex::find(const Query & query, const QHash<ObjectInstance*, QPoint> & positions) const
+{
+    auto name = query.name.toCaseFolded();
+    QVector<int> found;
+    auto matches = [&](int row, QPoint position) {
+        auto & entry = m_entries[row];
+        if (!query.objectId.isEmpty() && entry.objectId != query.objectId)
+            return false;
+        if (!query.region.isNull() && !query.region.contains(position))
+            return false;
+        if (!name.isEmpty() && !entry.name.contains(name))
+            return false;
+        return true;
+    };
+    // the moved instances are checked on their own, the candidates
+    // are chosen from the positions of the index
+    auto check = [&](int row) {
+        auto & entry = m_entries[row];
+        if (!positions.contains(entry.instance) && matches(row, entry.position))
+            found.append(row);
+    };
+
+    // the smallest list of candidates is checked, the object first,
+    // then the band of the region
+    if (!query.objectId.isEmpty())
+    {
+        for (int row : m_byObject.value(query.objectId))
+            check(row);
+    }
+    else if (!query.region.isNull())
+    {
+        auto first = std::lower_bound(m_byX.begin(), m_byX.end(), query.region.left(), [this](int row, int x) {
+            return m_entries[row].position.x() < x;
+        });
+        auto last = std::upper_bound(first, m_byX.end(), query.region.right(), [this](int x, int row) {
+            return x < m_entries[row].position.x();
+        });
+
+        QVector<int> rows;
+        rows.reserve(int(last - first));
+        for (auto it = first; it != last; ++it)
+            rows.append(*it);
+        std::sort(rows.begin(), rows.end());
+
+        for (int row : rows)
+            check(row);
+    }
+    else
+    {
+        for (int row = 0; row < m_entries.size(); row++)
+            check(row);
+    }
+
+    if (!positions.isEmpty())
+    {
+        for (auto it = positions.begin(); it != positions.end(); ++it)
+        {
+            int row = m_rows.value(it.key(), -1);
+            if (row >= 0 && matches(row, it.value()))
+                found.append(row);
+        }
+        std::sort(found.begin(), found.end());
+    }
+
+    QVector<ObjectInstance*> instances;
+    instances.reserve(found.size());
+    for (int row : found)
+        instances.append(m_entries[row].instance);
+    return instances;
+}
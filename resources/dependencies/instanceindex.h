@@ -0,0 +1,68 @@
+/*
+    Copyright (C) 2018  Alexander Roper
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef INSTANCEINDEX_H
+#define INSTANCEINDEX_H
+
+#include <QHash>
+#include <QPoint>
+#include <QRect>
+#include <QString>
+#include <QVector>
+
+class RoomLayer;
+class ObjectInstance;
+// answers the searches on the instances of a room without going through the layers
+class InstanceIndex
+{
+public:
+    struct Query
+    {
+        // empty for every object
+        QString objectId;
+        // part of the name, the case is ignored
+        QString name;
+        // in room coordinates, null for the whole room
+        QRect region;
+    };
+
+    void build(const QVector<RoomLayer*> & layers);
+    void clear();
+    int size() const;
+
+    // the instances are in the order of the room, layer by layer;
+    // positions replace the ones of the instances moved since the index was built
+    QVector<ObjectInstance*> find(const Query & query, const QHash<ObjectInstance*, QPoint> & positions = {}) const;
+
+private:
+    struct Entry
+    {
+        ObjectInstance * instance;
+        QString name;
+        QString objectId;
+        QPoint position;
+    };
+
+    QVector<Entry> m_entries;
+    // rows of the entries of each object
+    QHash<QString, QVector<int>> m_byObject;
+    // rows of the entries, sorted by x
+    QVector<int> m_byX;
+    QHash<ObjectInstance*, int> m_rows;
+};
+
+#endif // INSTANCEINDEX_H
@@ -17,7 +17,9 @@
 
 #include "instancelayer.h"
 #include "objectinstance.h"
+#include "utils/jsonwriter.h"
 #include <QJsonArray>
+#include <algorithm>
 
 InstanceLayer::InstanceLayer()
     : RoomLayer { ResourceType::InstanceLayer }
@@ -38,7 +40,79 @@ void InstanceLayer::load(QJsonObject object)
     }
 }
 
+void InstanceLayer::write(JsonWriter & writer)
+{
+    // instances are streamed one by one instead of being packed in a QJsonArray
+    writer.writeObject(cachedJson(), fields(), {
+        { "instances", [this, &writer]() {
+            writer.beginArray();
+            for (auto & instance : m_instances)
+            {
+                writer.value(instance->save());
+            }
+            writer.endArray();
+        } }
+    });
+}
+
 QVector<ObjectInstance *> InstanceLayer::instances() const
 {
     return m_instances;
 }
+
+QVector<int> InstanceLayer::removeInstances(const QVector<ObjectInstance*> & instances)
+{
+    QHash<ObjectInstance*, int> removed;
+    for (auto & instance : instances)
+        removed.insert(instance, -1);
+
+    // one pass over the instances of the layer
+    QVector<ObjectInstance*> kept;
+    kept.reserve(m_instances.size());
+    for (int i = 0; i < m_instances.size(); i++)
+    {
+        auto it = removed.find(m_instances[i]);
+        if (it != removed.end())
+            it.value() = i;
+        else
+            kept.append(m_instances[i]);
+    }
+    m_instances = kept;
+
+    QVector<int> indexes;
+    indexes.reserve(instances.size());
+    for (auto & instance : instances)
+        indexes.append(removed.value(instance));
+    return indexes;
+}
+
+void InstanceLayer::insertInstances(const QVector<ObjectInstance*> & instances, const QVector<int> & indexes)
+{
+    QVector<QPair<int, ObjectInstance*>> inserted;
+    QVector<ObjectInstance*> appended;
+    for (int i = 0; i < instances.size(); i++)
+    {
+        int index = i < indexes.size() ? indexes[i] : -1;
+        if (index < 0)
+            appended.append(instances[i]);
+        else
+            inserted.append({ index, instances[i] });
+    }
+    std::sort(inserted.begin(), inserted.end());
+
+    // the indexes are the ones in the final list, so they are filled in order
+    QVector<ObjectInstance*> result;
+    result.reserve(m_instances.size() + instances.size());
+    int next = 0;
+    for (auto & instance : m_instances)
+    {
+        while (next < inserted.size() && inserted[next].first <= result.size())
+            result.append(inserted[next++].second);
+        result.append(instance);
+    }
+    while (next < inserted.size())
+        result.append(inserted[next++].second);
+
+    result += appended;
+    m_instances = result;
+}
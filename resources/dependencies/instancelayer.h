@@ -28,8 +28,15 @@ public:
     InstanceLayer();
 
     void load(QJsonObject object);
+    void write(JsonWriter & writer) override;
     QVector<ObjectInstance*> instances() const;
 
+    // returns the index each instance had, or -1
+    QVector<int> removeInstances(const QVector<ObjectInstance*> & instances);
+    // puts back the instances at the indexes given by removeInstances,
+    // instances without index are appended
+    void insertInstances(const QVector<ObjectInstance*> & instances, const QVector<int> & indexes);
+
 private:
     QVector<ObjectInstance*> m_instances;
 };
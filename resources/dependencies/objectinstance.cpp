@@ -26,6 +26,8 @@ ObjectInstance::ObjectInstance()
 
 void ObjectInstance::load(QJsonObject object)
 {
+    m_cachedJson = object;
+
     setId(object["id"].toString());
     ResourceItem::registerItem(id(), this);
 
@@ -37,11 +39,34 @@ void ObjectInstance::load(QJsonObject object)
     m_objId = object["objId"].toString();
 }
 
+QJsonObject ObjectInstance::save()
+{
+    // the fields that are not handled are kept untouched
+    QJsonObject object = m_cachedJson;
+    object["id"] = id();
+    object["name"] = name();
+    object["x"] = m_position.x();
+    object["y"] = m_position.y();
+    object["objId"] = m_objId;
+
+    return object;
+}
+
 QPoint ObjectInstance::position() const
 {
     return m_position;
 }
 
+void ObjectInstance::setPosition(QPoint position)
+{
+    m_position = position;
+}
+
+QString ObjectInstance::objectId() const
+{
+    return m_objId;
+}
+
 ObjectResourceItem *ObjectInstance::object()
 {
     if (!Uuid::isNull(m_objId))
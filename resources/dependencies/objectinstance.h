@@ -29,10 +29,15 @@ public:
     ObjectInstance();
 
     void load(QJsonObject object) override;
+    QJsonObject save() override;
+
     QPoint position() const;
+    void setPosition(QPoint position);
     ObjectResourceItem * object();
+    QString objectId() const;
 
 private:
+    QJsonObject m_cachedJson;
     QPoint m_position;
     QString m_objId;
 };
@@ -16,6 +16,7 @@
 */
 
 #include "roomlayer.h"
+#include "utils/jsonwriter.h"
 
 RoomLayer::RoomLayer(ResourceType type)
     : ResourceItem { type }
@@ -24,6 +25,8 @@ RoomLayer::RoomLayer(ResourceType type)
         m_type = Type::Background;
     else if (type == ResourceType::InstanceLayer)
         m_type = Type::Instances;
+    else if (type == ResourceType::TileLayer)
+        m_type = Type::Tiles;
 }
 
 int RoomLayer::depth() const
@@ -38,11 +41,43 @@ void RoomLayer::setDepth(int d)
 
 void RoomLayer::load(QJsonObject object)
 {
+    m_cachedJson = object;
+
     setId(object["id"].toString());
     setName(object["name"].toString());
     setDepth(object["depth"].toInt());
 }
 
+QJsonObject RoomLayer::save()
+{
+    QJsonObject object = m_cachedJson;
+    auto changes = fields();
+    for (auto it = changes.constBegin(); it != changes.constEnd(); ++it)
+    {
+        object[it.key()] = it.value();
+    }
+    return object;
+}
+
+void RoomLayer::write(JsonWriter & writer)
+{
+    writer.value(save());
+}
+
+QJsonObject RoomLayer::fields() const
+{
+    QJsonObject object;
+    object["id"] = id();
+    object["name"] = name();
+    object["depth"] = m_depth;
+    return object;
+}
+
+QJsonObject RoomLayer::cachedJson() const
+{
+    return m_cachedJson;
+}
+
 RoomLayer::Type RoomLayer::type() const
 {
     return m_type;
@@ -20,6 +20,7 @@
 
 #include "resources/resourceitem.h"
 
+class JsonWriter;
 class RoomLayer : public ResourceItem
 {
     Q_OBJECT
@@ -28,6 +29,7 @@ public:
     enum class Type {
         Instances,
         Background,
+        Tiles,
         Unknown
     };
 
@@ -35,14 +37,19 @@ public:
     ~RoomLayer() = default;
 
     void load(QJsonObject object);
+    QJsonObject save() override;
+    virtual void write(JsonWriter & writer);
     Type type() const;
 
     int depth() const;
 
 protected:
     void setDepth(int d);
+    virtual QJsonObject fields() const;
+    QJsonObject cachedJson() const;
 
 private:
+    QJsonObject m_cachedJson;
     int m_depth = 0;
     Type m_type = Type::Unknown;
 };
@@ -0,0 +1,72 @@
+/*
+    Copyright (C) 2018  Alexander Roper
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+        "id": "a1b2c3d4-0000-0000-0000-000000000000",
+        "inheritPhysicsSettings": false,
+        "modelName": "GMRoomPhysicsSettings",
+        "PhysicsWorld": false,
+        "PhysicsWorldGravityX": 0,
+        "PhysicsWorldGravityY": 10,
+        "PhysicsWorldPixToMeters": 0.1,
+        "mvc": "1.0"*/
+
+#include "roomphysicssettings.h"
+
+RoomPhysicsSettings::RoomPhysicsSettings()
+    : ResourceItem { ResourceType::RoomPhysicsSettings }
+{
+}
+
+void RoomPhysicsSettings::load(QJsonObject object)
+{
+    m_cachedJson = object;
+
+    setId(object["id"].toString());
+
+    m_physicsWorld = object["PhysicsWorld"].toBool();
+    m_gravity = QPointF(object["PhysicsWorldGravityX"].toDouble(), object["PhysicsWorldGravityY"].toDouble(10));
+    m_pixelsToMeters = object["PhysicsWorldPixToMeters"].toDouble(0.1);
+    m_inheritPhysicsSettings = object["inheritPhysicsSettings"].toBool();
+}
+
+QJsonObject RoomPhysicsSettings::save()
+{
+    QJsonObject object = m_cachedJson;
+    object["id"] = id();
+    object["PhysicsWorld"] = m_physicsWorld;
+    object["PhysicsWorldGravityX"] = m_gravity.x();
+    object["PhysicsWorldGravityY"] = m_gravity.y();
+    object["PhysicsWorldPixToMeters"] = m_pixelsToMeters;
+    object["inheritPhysicsSettings"] = m_inheritPhysicsSettings;
+    return object;
+}
+
+bool RoomPhysicsSettings::isPhysicsWorld() const
+{
+    return m_physicsWorld;
+}
+
+QPointF RoomPhysicsSettings::gravity() const
+{
+    return m_gravity;
+}
+
+qreal RoomPhysicsSettings::pixelsToMeters() const
+{
+    return m_pixelsToMeters;
+}
@@ -24,6 +24,8 @@ RoomSettings::RoomSettings()
 
 void RoomSettings::load(QJsonObject object)
 {
+    m_cachedJson = object;
+
     setId(object["id"].toString());
     setName(object["name"].toString());
 
@@ -32,6 +34,16 @@ void RoomSettings::load(QJsonObject object)
     m_inheritRoomSettings = object["inheritRoomSettings"].toBool();
 }
 
+QJsonObject RoomSettings::save()
+{
+    QJsonObject object = m_cachedJson;
+    object["id"] = id();
+    object["Height"] = m_height;
+    object["Width"] = m_width;
+    object["inheritRoomSettings"] = m_inheritRoomSettings;
+    return object;
+}
+
 int RoomSettings::height() const
 {
     return m_height;
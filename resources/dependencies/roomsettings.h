@@ -28,11 +28,13 @@ public:
     RoomSettings();
 
     void load(QJsonObject object) override;
+    QJsonObject save() override;
 
     int height() const;
     int width() const;
 
 private:
+    QJsonObject m_cachedJson;
     int m_width = 0;
     int m_height = 0;
     bool m_inheritRoomSettings = false;
@@ -0,0 +1,114 @@
+/*
+    Copyright (C) 2018  Alexander Roper
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+        "id": "a1b2c3d4-0000-0000-0000-000000000000",
+        "modelName": "GMRView",
+        "mvc": "1.0",
+        "hborder": 32,
+        "hport": 768,
+        "hspeed": -1,
+        "hview": 768,
+        "inherit": false,
+        "objId": "00000000-0000-0000-0000-000000000000",
+        "vborder": 32,
+        "visible": false,
+        "vspeed": -1,
+        "wport": 1024,
+        "wview": 1024,
+        "xport": 0,
+        "xview": 0,
+        "yport": 0,
+        "yview": 0*/
+
+#include "roomview.h"
+#include "utils/uuid.h"
+#include "resources/objectresourceitem.h"
+
+RoomView::RoomView()
+    : ResourceItem { ResourceType::RoomView }
+{
+}
+
+void RoomView::load(QJsonObject object)
+{
+    m_cachedJson = object;
+
+    setId(object["id"].toString());
+
+    m_visible = object["visible"].toBool();
+    m_inherit = object["inherit"].toBool();
+    m_camera = QRect(object["xview"].toInt(), object["yview"].toInt(), object["wview"].toInt(), object["hview"].toInt());
+    m_port = QRect(object["xport"].toInt(), object["yport"].toInt(), object["wport"].toInt(), object["hport"].toInt());
+    m_border = QSize(object["hborder"].toInt(), object["vborder"].toInt());
+    m_speed = QPoint(object["hspeed"].toInt(), object["vspeed"].toInt());
+    m_objId = object["objId"].toString();
+}
+
+QJsonObject RoomView::save()
+{
+    QJsonObject object = m_cachedJson;
+    object["id"] = id();
+    object["visible"] = m_visible;
+    object["inherit"] = m_inherit;
+    object["xview"] = m_camera.x();
+    object["yview"] = m_camera.y();
+    object["wview"] = m_camera.width();
+    object["hview"] = m_camera.height();
+    object["xport"] = m_port.x();
+    object["yport"] = m_port.y();
+    object["wport"] = m_port.width();
+    object["hport"] = m_port.height();
+    object["hborder"] = m_border.width();
+    object["vborder"] = m_border.height();
+    object["hspeed"] = m_speed.x();
+    object["vspeed"] = m_speed.y();
+    object["objId"] = m_objId;
+    return object;
+}
+
+bool RoomView::isVisible() const
+{
+    return m_visible;
+}
+
+QRect RoomView::camera() const
+{
+    return m_camera;
+}
+
+QRect RoomView::port() const
+{
+    return m_port;
+}
+
+QSize RoomView::border() const
+{
+    return m_border;
+}
+
+QPoint RoomView::speed() const
+{
+    return m_speed;
+}
+
+ObjectResourceItem * RoomView::followedObject() const
+{
+    if (!Uuid::isNull(m_objId))
+        return ResourceItem::get<ObjectResourceItem>(m_objId);
+    return nullptr;
+}
@@ -0,0 +1,56 @@
+/*
+    Copyright (C) 2018  Alexander Roper
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef ROOMVIEW_H
+#define ROOMVIEW_H
+
+#include "resources/resourceitem.h"
+#include <QRect>
+
+class RoomView : public ResourceItem
+{
+    Q_OBJECT
+
+public:
+    RoomView();
+
+    void load(QJsonObject object) override;
+    QJsonObject save() override;
+
+    bool isVisible() const;
+    // the part of the room seen by the camera, at the start of the room
+    QRect camera() const;
+    // where the camera is shown in the window
+    QRect port() const;
+    // the margins kept around the followed object
+    QSize border() const;
+    // -1 for an instant move
+    QPoint speed() const;
+    ObjectResourceItem * followedObject() const;
+
+private:
+    QJsonObject m_cachedJson;
+    bool m_visible = false;
+    bool m_inherit = false;
+    QRect m_camera;
+    QRect m_port;
+    QSize m_border;
+    QPoint m_speed;
+    QString m_objId;
+};
+
+#endif // ROOMVIEW_H
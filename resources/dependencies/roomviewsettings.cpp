@@ -0,0 +1,70 @@
+/*
+    Copyright (C) 2018  Alexander Roper
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+        "id": "a1b2c3d4-0000-0000-0000-000000000000",
+        "clearDisplayBuffer": true,
+        "clearViewBackground": false,
+        "enableViews": false,
+        "inheritViewSettings": false,
+        "modelName": "GMRoomViewSettings",
+        "mvc": "1.0"*/
+
+#include "roomviewsettings.h"
+
+RoomViewSettings::RoomViewSettings()
+    : ResourceItem { ResourceType::RoomViewSettings }
+{
+}
+
+void RoomViewSettings::load(QJsonObject object)
+{
+    m_cachedJson = object;
+
+    setId(object["id"].toString());
+
+    m_enableViews = object["enableViews"].toBool();
+    m_clearDisplayBuffer = object["clearDisplayBuffer"].toBool(true);
+    m_clearViewBackground = object["clearViewBackground"].toBool();
+    m_inheritViewSettings = object["inheritViewSettings"].toBool();
+}
+
+QJsonObject RoomViewSettings::save()
+{
+    QJsonObject object = m_cachedJson;
+    object["id"] = id();
+    object["enableViews"] = m_enableViews;
+    object["clearDisplayBuffer"] = m_clearDisplayBuffer;
+    object["clearViewBackground"] = m_clearViewBackground;
+    object["inheritViewSettings"] = m_inheritViewSettings;
+    return object;
+}
+
+bool RoomViewSettings::areViewsEnabled() const
+{
+    return m_enableViews;
+}
+
+bool RoomViewSettings::clearsDisplayBuffer() const
+{
+    return m_clearDisplayBuffer;
+}
+
+bool RoomViewSettings::clearsViewBackground() const
+{
+    return m_clearViewBackground;
+}
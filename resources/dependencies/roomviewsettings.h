@@ -0,0 +1,45 @@
+/*
+    Copyright (C) 2018  Alexander Roper
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef ROOMVIEWSETTINGS_H
+#define ROOMVIEWSETTINGS_H
+
+#include "resources/resourceitem.h"
+
+class RoomViewSettings : public ResourceItem
+{
+    Q_OBJECT
+
+public:
+    RoomViewSettings();
+
+    void load(QJsonObject object) override;
+    QJsonObject save() override;
+
+    bool areViewsEnabled() const;
+    bool clearsDisplayBuffer() const;
+    bool clearsViewBackground() const;
+
+private:
+    QJsonObject m_cachedJson;
+    bool m_enableViews = false;
+    bool m_clearDisplayBuffer = true;
+    bool m_clearViewBackground = false;
+    bool m_inheritViewSettings = false;
+};
+
+#endif // ROOMVIEWSETTINGS_H
@@ -0,0 +1,187 @@
+/*
+    Copyright (C) 2018  Alexander Roper
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "tilelayer.h"
+#include "resources/tilesetresourceitem.h"
+#include "utils/jsonwriter.h"
+#include "utils/uuid.h"
+#include <QJsonArray>
+#include <algorithm>
+
+TileLayer::TileLayer()
+    : RoomLayer { ResourceType::TileLayer }
+{
+}
+
+void TileLayer::load(QJsonObject object)
+{
+    RoomLayer::load(object);
+
+    m_tileSetId = object["tilesetId"].toString();
+    m_offset = QPoint(object["x"].toInt(), object["y"].toInt());
+
+    auto tilesJson = object["tiles"].toObject();
+    m_width = tilesJson["SerialiseWidth"].toInt();
+    m_height = tilesJson["SerialiseHeight"].toInt();
+
+    auto data = tilesJson["TileSerialiseData"].toArray();
+    bool emptyFound = false;
+    for (int i = 0; i < data.size() && m_width > 0; i++)
+    {
+        auto tile = static_cast<quint32>(data[i].toDouble());
+        if (isEmpty(tile))
+        {
+            if (!emptyFound)
+            {
+                m_emptyTile = tile;
+                emptyFound = true;
+            }
+            else if (tile != m_emptyTile)
+            {
+                m_emptyValues.insert(key(i % m_width, i / m_width), tile);
+            }
+            continue;
+        }
+        setTile(i % m_width, i / m_width, tile);
+    }
+}
+
+void TileLayer::write(JsonWriter & writer)
+{
+    // the tiles are streamed row by row from the chunks
+    writer.writeObject(cachedJson(), fields(), {
+        { "tiles", [this, &writer]() {
+            QJsonObject tilesJson = cachedJson()["tiles"].toObject();
+            QJsonObject sizes;
+            sizes["SerialiseWidth"] = m_width;
+            sizes["SerialiseHeight"] = m_height;
+
+            writer.writeObject(tilesJson, sizes, {
+                { "TileSerialiseData", [this, &writer]() {
+                    writer.beginArray();
+                    for (int y = 0; y < m_height; y++)
+                    {
+                        for (int x = 0; x < m_width; x++)
+                        {
+                            auto value = tile(x, y);
+                            if (isEmpty(value))
+                            {
+                                // written back as it was read, unless the cell was edited
+                                value = m_emptyValues.isEmpty() ? m_emptyTile : m_emptyValues.value(key(x, y), m_emptyTile);
+                            }
+                            writer.value(static_cast<qint64>(value));
+                        }
+                    }
+                    writer.endArray();
+                } }
+            });
+        } }
+    });
+}
+
+QJsonObject TileLayer::fields() const
+{
+    QJsonObject object = RoomLayer::fields();
+    object["tilesetId"] = m_tileSetId;
+    object["x"] = m_offset.x();
+    object["y"] = m_offset.y();
+    return object;
+}
+
+TileSetResourceItem * TileLayer::tileSet() const
+{
+    if (!Uuid::isNull(m_tileSetId))
+        return ResourceItem::get<TileSetResourceItem>(m_tileSetId);
+    return nullptr;
+}
+
+QPoint TileLayer::offset() const
+{
+    return m_offset;
+}
+
+int TileLayer::width() const
+{
+    return m_width;
+}
+
+int TileLayer::height() const
+{
+    return m_height;
+}
+
+quint32 TileLayer::tile(int x, int y) const
+{
+    if (x < 0 || y < 0)
+        return 0;
+
+    auto it = m_chunks.find(key(x / CHUNK_SIZE, y / CHUNK_SIZE));
+    if (it == m_chunks.end())
+        return 0;
+    return it.value()[(y % CHUNK_SIZE) * CHUNK_SIZE + x % CHUNK_SIZE];
+}
+
+void TileLayer::setTile(int x, int y, quint32 tile)
+{
+    if (x < 0 || y < 0 || x >= m_width || y >= m_height)
+        return;
+
+    m_emptyValues.remove(key(x, y));
+    auto chunkKey = key(x / CHUNK_SIZE, y / CHUNK_SIZE);
+    auto it = m_chunks.find(chunkKey);
+    if (it == m_chunks.end())
+    {
+        if (isEmpty(tile))
+            return;
+        it = m_chunks.insert(chunkKey, QVector<quint32>(CHUNK_SIZE * CHUNK_SIZE, 0));
+    }
+    it.value()[(y % CHUNK_SIZE) * CHUNK_SIZE + x % CHUNK_SIZE] = isEmpty(tile) ? 0 : tile;
+
+    if (isEmpty(tile))
+    {
+        // the chunk goes away with its last tile
+        bool empty = std::all_of(it.value().cbegin(), it.value().cend(), [](quint32 t) { return t == 0; });
+        if (empty)
+            m_chunks.erase(it);
+    }
+}
+
+bool TileLayer::isEmpty(quint32 tile)
+{
+    // the first tile of a tileset is always transparent
+    return (tile & TILE_INDEX) == 0;
+}
+
+QList<QPoint> TileLayer::chunks() const
+{
+    QList<QPoint> result;
+    for (auto it = m_chunks.cbegin(); it != m_chunks.cend(); ++it)
+    {
+        result.append(QPoint(static_cast<qint32>(it.key() >> 32), static_cast<qint32>(it.key() & 0xFFFFFFFF)));
+    }
+    return result;
+}
+
+QVector<quint32> TileLayer::chunk(const QPoint & chunk) const
+{
+    return m_chunks.value(key(chunk.x(), chunk.y()));
+}
+
+quint64 TileLayer::key(int x, int y)
+{
+    return (quint64(quint32(x)) << 32) | quint32(y);
+}
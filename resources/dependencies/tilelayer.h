@@ -0,0 +1,77 @@
+/*
+    Copyright (C) 2018  Alexander Roper
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef TILELAYER_H
+#define TILELAYER_H
+
+#include "roomlayer.h"
+#include <QHash>
+#include <QPoint>
+#include <QVector>
+
+class TileSetResourceItem;
+class TileLayer : public RoomLayer
+{
+    Q_OBJECT
+
+public:
+    // the tiles are stored by square chunks, only the chunks with tiles exist
+    static const int CHUNK_SIZE = 32;
+
+    static const quint32 TILE_INDEX = 0x0007FFFF;
+    static const quint32 TILE_MIRROR = 0x10000000;
+    static const quint32 TILE_FLIP = 0x20000000;
+    static const quint32 TILE_ROTATE = 0x40000000;
+
+    TileLayer();
+
+    void load(QJsonObject object);
+    void write(JsonWriter & writer) override;
+
+    TileSetResourceItem * tileSet() const;
+    QPoint offset() const;
+
+    // in tiles
+    int width() const;
+    int height() const;
+
+    quint32 tile(int x, int y) const;
+    void setTile(int x, int y, quint32 tile);
+    static bool isEmpty(quint32 tile);
+
+    QList<QPoint> chunks() const;
+    // CHUNK_SIZE * CHUNK_SIZE tiles, row by row
+    QVector<quint32> chunk(const QPoint & chunk) const;
+
+protected:
+    QJsonObject fields() const override;
+
+private:
+    static quint64 key(int x, int y);
+
+    QString m_tileSetId;
+    QPoint m_offset;
+    int m_width = 0;
+    int m_height = 0;
+    // value used by the file for the empty tiles
+    quint32 m_emptyTile = 0x80000000;
+    // the empty tiles of the file with another value, like flags, by cell
+    QHash<quint64, quint32> m_emptyValues;
+    QHash<quint64, QVector<quint32>> m_chunks;
+};
+
+#endif // TILELAYER_H
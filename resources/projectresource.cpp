@@ -17,7 +17,8 @@
 
 #include "projectresource.h"
 #include "utils/utils.h"
-#include "utils/uuid.h"
+#include <QSet>
+#include <QUuid>
 
 ProjectResource::ProjectResource()
     : ResourceItem { ResourceType::Project }
@@ -62,75 +63,121 @@ void ProjectResource::load(QJsonObject object)
 }
 
 
+// whether the resource is listed in the "resources" field of the project
+static bool isProjectEntry(ResourceType type)
+{
+    switch (type)
+    {
+    case ResourceType::AmazonFireOptions:
+    case ResourceType::AndroidOptions:
+    case ResourceType::Extension:
+    case ResourceType::Folder:
+    case ResourceType::Font:
+    case ResourceType::iOSOptions:
+    case ResourceType::LinuxOptions:
+    case ResourceType::MacOptions:
+    case ResourceType::Notes:
+    case ResourceType::Object:
+    case ResourceType::Path:
+    case ResourceType::Room:
+    case ResourceType::Root:
+    case ResourceType::Script:
+    case ResourceType::Shader:
+    case ResourceType::Sound:
+    case ResourceType::Sprite:
+    case ResourceType::TileSet:
+    case ResourceType::Timeline:
+    case ResourceType::WindowsOptions:
+        // add those to the project file
+        return true;
+    case ResourceType::BackgroundLayer:
+    case ResourceType::Config:
+    case ResourceType::Event:
+    case ResourceType::ImageLayer:
+    case ResourceType::IncludedFile:
+    case ResourceType::InstanceLayer:
+    case ResourceType::MainOptions:
+    case ResourceType::ObjectInstance:
+    case ResourceType::Options:
+    case ResourceType::Project:
+    case ResourceType::RoomPhysicsSettings:
+    case ResourceType::RoomSettings:
+    case ResourceType::RoomView:
+    case ResourceType::RoomViewSettings:
+    case ResourceType::SpriteFrame:
+    case ResourceType::SpriteImage:
+    case ResourceType::TileLayer:
+    case ResourceType::Unknown:
+        // don't add those
+        return false;
+    default:
+        // easier to find missing values
+        throw 42;
+    }
+}
+
 QJsonObject ProjectResource::save()
 {
     auto resources = ResourceItem::all();
+    QSet<QString> savedIds;
 
+    // the entries already in the project file keep their order and their ids,
+    // so saving an unchanged project gives the same file
     QJsonArray resourcesJson;
-    for(auto & resource : resources)
+    for (const auto & value : m_cachedProjectFile["resources"].toArray())
     {
-        switch (resource->type())
+        auto entry = value.toObject();
+        auto key = entry["Key"].toString();
+        auto resource = resources.value(key);
+        if (resource == nullptr || savedIds.contains(key))
         {
-        case ResourceType::AmazonFireOptions:
-        case ResourceType::AndroidOptions:
-        case ResourceType::Extension:
-        case ResourceType::Folder:
-        case ResourceType::Font:
-        case ResourceType::iOSOptions:
-        case ResourceType::LinuxOptions:
-        case ResourceType::MacOptions:
-        case ResourceType::Notes:
-        case ResourceType::Object:
-        case ResourceType::Path:
-        case ResourceType::Room:
-        case ResourceType::Root:
-        case ResourceType::Script:
-        case ResourceType::Shader:
-        case ResourceType::Sound:
-        case ResourceType::Sprite:
-        case ResourceType::TileSet:
-        case ResourceType::Timeline:
-        case ResourceType::WindowsOptions:
-            // add those to the project file
-            break;
-        case ResourceType::BackgroundLayer:
-        case ResourceType::Config:
-        case ResourceType::Event:
-        case ResourceType::ImageLayer:
-        case ResourceType::IncludedFile:
-        case ResourceType::InstanceLayer:
-        case ResourceType::MainOptions:
-        case ResourceType::ObjectInstance:
-        case ResourceType::Options:
-        case ResourceType::Project:
-        case ResourceType::RoomSettings:
-        case ResourceType::SpriteFrame:
-        case ResourceType::SpriteImage:
-        case ResourceType::Unknown:
-            // don't add those
+            // removed from the project
             continue;
-        default:
-            // easier to find missing values
-            throw 42;
         }
-        QString path = resource->filename();
 
-        QJsonObject value;
-        value["id"] = Uuid::generate();
-        value["resourcePath"] = path.replace("/", "\\");
-        value["resourceType"] = Utils::resourceTypeToString(resource->type());
+        // resources not handled by the editor are kept as they were loaded
+        if (isProjectEntry(resource->type()))
+        {
+            entry = saveEntry(resource, entry["Value"].toObject());
+        }
 
-        QJsonObject object;
-        object["Key"] = resource->id();
-        object["Value"] = value;
+        resourcesJson.append(entry);
+        savedIds.insert(key);
+    }
 
-        resourcesJson.append(object);
+    // new resources are added in the order of their keys
+    for (auto & resource : resources)
+    {
+        if (!savedIds.contains(resource->id()) && isProjectEntry(resource->type()))
+        {
+            resourcesJson.append(saveEntry(resource, {}));
+        }
     }
     m_cachedProjectFile["resources"] = resourcesJson;
 
     return m_cachedProjectFile;
 }
 
+QJsonObject ProjectResource::saveEntry(ResourceItem * resource, QJsonObject value) const
+{
+    if (value["id"].toString().isEmpty())
+    {
+        // derived from the resource id so it's the same on every save
+        QString uuid = QUuid::createUuidV5(QUuid(id()), resource->id()).toString();
+        value["id"] = uuid.mid(1, uuid.length() - 2);
+    }
+
+    QString path = resource->filename();
+    value["resourcePath"] = path.replace("/", "\\");
+    value["resourceType"] = Utils::resourceTypeToString(resource->type());
+
+    QJsonObject object;
+    object["Key"] = resource->id();
+    object["Value"] = value;
+
+    return object;
+}
+
 
 QString ProjectResource::filename() const
 {
@@ -32,6 +32,8 @@ public:
     QString filename() const override;
 
 private:
+    QJsonObject saveEntry(ResourceItem * resource, QJsonObject value) const;
+
     QJsonObject m_cachedProjectFile;
 };
 
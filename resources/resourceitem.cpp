@@ -118,6 +118,9 @@ ResourceItem *ResourceItem::create(ResourceType type, QString id)
     case ResourceType::Sprite:
         item = new SpriteResourceItem;
         break;
+    case ResourceType::TileSet:
+        item = new TileSetResourceItem;
+        break;
     case ResourceType::WindowsOptions:
         item = new WindowsOptionsResourceItem;
         break;
@@ -127,6 +130,9 @@ ResourceItem *ResourceItem::create(ResourceType type, QString id)
     case ResourceType::BackgroundLayer:
         item = new BackgroundLayer;
         break;
+    case ResourceType::TileLayer:
+        item = new TileLayer;
+        break;
     default:
         item = new UnknownResourceItem;
     }
@@ -145,6 +151,14 @@ void ResourceItem::registerItem(QString id, ResourceItem * item)
     }
 }
 
+void ResourceItem::unregisterItem(QString id, ResourceItem * item)
+{
+    if (allResources.value(id) == item)
+    {
+        allResources.remove(id);
+    }
+}
+
 ResourceItem *ResourceItem::get(QString id)
 {
     Q_ASSERT(!Uuid::isNull(id));
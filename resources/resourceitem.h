@@ -49,7 +49,10 @@ enum class ResourceType
     Path,
     Project,
     Room,
+    RoomPhysicsSettings,
     RoomSettings,
+    RoomView,
+    RoomViewSettings,
     Root,
     Script,
     Shader,
@@ -57,6 +60,7 @@ enum class ResourceType
     Sprite,
     SpriteFrame,
     SpriteImage,
+    TileLayer,
     TileSet,
     Timeline,
     WindowsOptions,
@@ -88,6 +92,8 @@ public:
 
     static ResourceItem* create(ResourceType type, QString id);
     static void registerItem(QString id, ResourceItem * item);
+    // only if the id is still the one of the item
+    static void unregisterItem(QString id, ResourceItem * item);
     static ResourceItem* get(QString id);
     template <typename T>
     static T* get(QString id)
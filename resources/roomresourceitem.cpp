@@ -17,9 +17,15 @@
 
 #include "roomresourceitem.h"
 #include "dependencies/roomlayer.h"
+#include "dependencies/instancelayer.h"
+#include "dependencies/objectinstance.h"
+#include "dependencies/roomview.h"
 #include "utils/utils.h"
 #include "utils/uuid.h"
+#include "utils/jsonwriter.h"
+#include "gamesettings.h"
 #include <QJsonArray>
+#include <QSet>
 
 RoomResourceItem::RoomResourceItem()
     : ResourceItem { ResourceType::Room }
@@ -28,10 +34,22 @@ RoomResourceItem::RoomResourceItem()
 
 void RoomResourceItem::load(QJsonObject object)
 {
+    m_cachedJson = object;
+
     setName(object["name"].toString());
 
     auto roomSettings = object["roomSettings"].toObject();
     m_settings.load(roomSettings);
+    m_viewSettings.load(object["viewSettings"].toObject());
+    m_physicsSettings.load(object["physicsSettings"].toObject());
+
+    for (const auto & value : object["views"].toArray())
+    {
+        auto view = new RoomView;
+        view->setParent(this);
+        view->load(value.toObject());
+        m_views.append(view);
+    }
 
     auto layers = object["layers"].toArray();
     for (const auto & value : layers)
@@ -40,11 +58,128 @@ void RoomResourceItem::load(QJsonObject object)
 
         auto layerType = Utils::resourceStringToType(layerJson["modelName"].toString());
         auto id = layerJson["id"].toString();
-        auto layer = ResourceItem::create(layerType, id);
+        auto item = ResourceItem::create(layerType, id);
+        auto layer = qobject_cast<RoomLayer*>(item);
+        if (layer == nullptr)
+        {
+            // layers not handled by the editor are kept as they are
+            delete item;
+            layer = new RoomLayer(ResourceType::Unknown);
+            ResourceItem::registerItem(id, layer);
+        }
         layer->load(layerJson);
 
-        m_layers.append(qobject_cast<RoomLayer*>(layer));
+        m_layers.append(layer);
+    }
+
+    m_instanceIndex.build(m_layers);
+    m_instanceIndexValid = true;
+}
+
+bool RoomResourceItem::reload()
+{
+    auto json = Utils::readFileToJSON(QString("%1/%2").arg(GameSettings::rootPath(), filename()));
+    if (json.isEmpty())
+        return false;
+
+    // the layers and their instances are registered by their id,
+    // the new ones take their place
+    for (auto & layer : m_layers)
+    {
+        if (auto instLayer = qobject_cast<InstanceLayer*>(layer))
+        {
+            for (auto & instance : instLayer->instances())
+            {
+                ResourceItem::unregisterItem(instance->id(), instance);
+                delete instance;
+            }
+        }
+        ResourceItem::unregisterItem(layer->id(), layer);
+        delete layer;
     }
+    m_layers.clear();
+    qDeleteAll(m_views);
+    m_views.clear();
+
+    load(json);
+    return true;
+}
+
+void RoomResourceItem::write(JsonWriter & writer)
+{
+    QJsonObject overrides;
+    overrides["id"] = id();
+    overrides["name"] = name();
+    overrides["roomSettings"] = m_settings.save();
+    // older rooms may not have those
+    if (m_cachedJson.contains("viewSettings"))
+        overrides["viewSettings"] = m_viewSettings.save();
+    if (m_cachedJson.contains("physicsSettings"))
+        overrides["physicsSettings"] = m_physicsSettings.save();
+    if (m_cachedJson.contains("views"))
+    {
+        QJsonArray views;
+        for (auto & view : m_views)
+        {
+            views.append(view->save());
+        }
+        overrides["views"] = views;
+    }
+
+    // each layer writes itself, so the instances are never all in memory as JSON
+    writer.writeObject(m_cachedJson, overrides, {
+        { "layers", [this, &writer]() {
+            writer.beginArray();
+            for (auto & layer : m_layers)
+            {
+                layer->write(writer);
+            }
+            writer.endArray();
+        } },
+        { "instanceCreationOrderIDs", [this, &writer]() {
+            writeCreationOrder(writer);
+        } }
+    });
+}
+
+void RoomResourceItem::writeCreationOrder(JsonWriter & writer) const
+{
+    QVector<QString> ids;
+    QSet<QString> existing;
+    for (auto & layer : m_layers)
+    {
+        if (auto instLayer = qobject_cast<InstanceLayer*>(layer))
+        {
+            for (auto & instance : instLayer->instances())
+            {
+                ids.append(instance->id());
+                existing.insert(instance->id());
+            }
+        }
+    }
+
+    // the known order is kept, without the deleted instances,
+    // and the new instances are created last
+    writer.beginArray();
+    QSet<QString> ordered;
+    for (const auto & value : m_cachedJson["instanceCreationOrderIDs"].toArray())
+    {
+        auto id = value.toString();
+        if (existing.contains(id) && !ordered.contains(id))
+        {
+            writer.value(id);
+            ordered.insert(id);
+        }
+    }
+    for (auto & id : ids)
+    {
+        if (!ordered.contains(id))
+        {
+            writer.value(id);
+            ordered.insert(id);
+        }
+    }
+    writer.endArray();
 }
 
 int RoomResourceItem::height() const
@@ -62,6 +197,36 @@ QVector<RoomLayer *> RoomResourceItem::layers() const
     return m_layers;
 }
 
+QVector<RoomView *> RoomResourceItem::views() const
+{
+    return m_views;
+}
+
+const RoomViewSettings & RoomResourceItem::viewSettings() const
+{
+    return m_viewSettings;
+}
+
+const RoomPhysicsSettings & RoomResourceItem::physicsSettings() const
+{
+    return m_physicsSettings;
+}
+
+const InstanceIndex & RoomResourceItem::instanceIndex()
+{
+    if (!m_instanceIndexValid)
+    {
+        m_instanceIndex.build(m_layers);
+        m_instanceIndexValid = true;
+    }
+    return m_instanceIndex;
+}
+
+void RoomResourceItem::invalidateInstanceIndex()
+{
+    m_instanceIndexValid = false;
+}
+
 QString RoomResourceItem::filename() const
 {
     return QString("rooms/%1/%1.yy").arg(name());
@@ -20,7 +20,12 @@
 
 #include "resourceitem.h"
 #include "dependencies/roomsettings.h"
+#include "dependencies/roomviewsettings.h"
+#include "dependencies/roomphysicssettings.h"
+#include "dependencies/instanceindex.h"
 
+class JsonWriter;
+class RoomView;
 class RoomResourceItem : public ResourceItem
 {
     Q_OBJECT
@@ -29,16 +34,36 @@ public:
     RoomResourceItem();
 
     void load(QJsonObject object) override;
+    // reads the room from its file again, the layers and the instances
+    // are new ones, false if the file can't be read
+    bool reload();
+    void write(JsonWriter & writer);
     QString filename() const override;
 
     int height() const;
     int width() const;
 
     QVector<RoomLayer *> layers() const;
+    QVector<RoomView *> views() const;
+    const RoomViewSettings & viewSettings() const;
+    const RoomPhysicsSettings & physicsSettings() const;
+
+    // built with the room, and again after invalidateInstanceIndex
+    const InstanceIndex & instanceIndex();
+    // to call when instances are added, removed or moved
+    void invalidateInstanceIndex();
 
 private:
+    void writeCreationOrder(JsonWriter & writer) const;
+
+    QJsonObject m_cachedJson;
     QVector<RoomLayer *> m_layers;
     RoomSettings m_settings;
+    QVector<RoomView *> m_views;
+    RoomViewSettings m_viewSettings;
+    RoomPhysicsSettings m_physicsSettings;
+    InstanceIndex m_instanceIndex;
+    bool m_instanceIndexValid = false;
 };
 
 #endif // ROOMRESOURCEITEM_H
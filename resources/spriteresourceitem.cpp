@@ -21,6 +21,10 @@
 #include <QJsonValue>
 #include <QPixmap>
 #include "gamesettings.h"
+#include "graphics/spritecache.h"
+
+// in frames per second, the default speed of the games
+static const qreal GAME_SPEED = 60;
 
 SpriteResourceItem::SpriteResourceItem()
     : ResourceItem { ResourceType::Sprite }
@@ -30,6 +34,13 @@ SpriteResourceItem::SpriteResourceItem()
 void SpriteResourceItem::load(QJsonObject object)
 {
     setName(object["name"].toString());
+    m_origin = QPoint(object["xorig"].toInt(), object["yorig"].toInt());
+    m_playbackSpeed = object["playbackSpeed"].toDouble(15);
+    m_playbackSpeedType = object["playbackSpeedType"].toInt();
+    m_size = QSize(object["width"].toInt(), object["height"].toInt());
+    m_boundingBox = QRect(QPoint(object["bbox_left"].toInt(), object["bbox_top"].toInt()),
+                          QPoint(object["bbox_right"].toInt(), object["bbox_bottom"].toInt()));
+    m_textureGroupId = object["textureGroupId"].toString();
 
     auto frames = object["frames"].toArray();
     for (const auto & frameJson : frames)
@@ -50,15 +61,52 @@ QPixmap SpriteResourceItem::thumbnail(int width, int height) const
     return pix;
 }
 
-QPixmap SpriteResourceItem::pixmap() const
+QPixmap SpriteResourceItem::pixmap(int frame) const
+{
+    return SpriteCache::pixmap(this, frame);
+}
+
+int SpriteResourceItem::frameCount() const
 {
-    if (m_frames.size() > 0)
+    return m_frames.size();
+}
+
+QString SpriteResourceItem::framePath(int frame) const
+{
+    if (frame >= 0 && frame < m_frames.size())
     {
-        auto composite = m_frames[0]->compositeImage();
-        QString path = QString("%1/sprites/%2/%3.png").arg(GameSettings::rootPath(), name(), composite->frameId());
-        return QPixmap(path);
+        auto composite = m_frames[frame]->compositeImage();
+        return QString("%1/sprites/%2/%3.png").arg(GameSettings::rootPath(), name(), composite->frameId());
     }
-    return QPixmap();
+    return QString();
+}
+
+QPoint SpriteResourceItem::origin() const
+{
+    return m_origin;
+}
+
+QSize SpriteResourceItem::size() const
+{
+    return m_size;
+}
+
+QRect SpriteResourceItem::boundingBox() const
+{
+    return m_boundingBox;
+}
+
+QString SpriteResourceItem::textureGroupId() const
+{
+    return m_textureGroupId;
+}
+
+qreal SpriteResourceItem::framesPerSecond() const
+{
+    // 0 is in frames per second, 1 in frames per game frame
+    if (m_playbackSpeedType == 1)
+        return m_playbackSpeed * GAME_SPEED;
+    return m_playbackSpeed;
 }
 
 
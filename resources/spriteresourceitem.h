@@ -19,6 +19,9 @@
 #define SPRITERESOURCEITEM_H
 
 #include "resourceitem.h"
+#include <QPoint>
+#include <QRect>
+#include <QSize>
 
 class SpriteFrame;
 class SpriteResourceItem : public ResourceItem
@@ -32,10 +35,26 @@ public:
     QString filename() const override;
 
     QPixmap thumbnail(int width = 100, int height = 100) const override;
-    QPixmap pixmap() const;
+    QPixmap pixmap(int frame = 0) const;
+
+    int frameCount() const;
+    QString framePath(int frame) const;
+    QPoint origin() const;
+    QSize size() const;
+    // the collision mask, relative to the top left corner of the sprite
+    QRect boundingBox() const;
+    QString textureGroupId() const;
+    // the playback speed of the sprite, whatever its unit in the file
+    qreal framesPerSecond() const;
 
 private:
     QVector<SpriteFrame*> m_frames;
+    QPoint m_origin;
+    QSize m_size;
+    QRect m_boundingBox;
+    QString m_textureGroupId;
+    qreal m_playbackSpeed = 0;
+    int m_playbackSpeedType = 0;
 };
 
 #endif // SPRITERESOURCEITEM_H
@@ -0,0 +1,92 @@
+/*
+    Copyright (C) 2018  Alexander Roper
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "tilesetresourceitem.h"
+#include "spriteresourceitem.h"
+#include "utils/uuid.h"
+#include <QPixmap>
+
+TileSetResourceItem::TileSetResourceItem()
+    : ResourceItem { ResourceType::TileSet }
+{
+}
+
+void TileSetResourceItem::load(QJsonObject object)
+{
+    setName(object["name"].toString());
+
+    m_spriteId = object["spriteId"].toString();
+    m_tileSize = QSize(object["tilewidth"].toInt(), object["tileheight"].toInt());
+    m_offset = QPoint(object["tilexoff"].toInt(), object["tileyoff"].toInt());
+    m_separation = QSize(object["tilehsep"].toInt(), object["tilevsep"].toInt());
+    m_tileCount = object["tile_count"].toInt();
+}
+
+QString TileSetResourceItem::filename() const
+{
+    return QString("tilesets/%1/%1.yy").arg(name());
+}
+
+QPixmap TileSetResourceItem::thumbnail(int width, int height) const
+{
+    if (auto pSprite = sprite())
+        return pSprite->thumbnail(width, height);
+    return QPixmap();
+}
+
+SpriteResourceItem * TileSetResourceItem::sprite() const
+{
+    if (!Uuid::isNull(m_spriteId))
+        return ResourceItem::get<SpriteResourceItem>(m_spriteId);
+    return nullptr;
+}
+
+QSize TileSetResourceItem::tileSize() const
+{
+    return m_tileSize;
+}
+
+int TileSetResourceItem::tileCount() const
+{
+    return m_tileCount;
+}
+
+QRect TileSetResourceItem::tileRect(int index) const
+{
+    if (m_tileSize.isEmpty() || index < 0 || index >= m_tileCount)
+        return QRect();
+
+    // the tiles are laid out in as many columns as fit in the sprite
+    if (m_columns == 0)
+    {
+        if (auto pSprite = sprite())
+        {
+            int width = pSprite->pixmap().width() - m_offset.x() + m_separation.width();
+            m_columns = qMax(1, width / (m_tileSize.width() + m_separation.width()));
+        }
+        else
+        {
+            return QRect();
+        }
+    }
+
+    int column = index % m_columns;
+    int row = index / m_columns;
+    return QRect(m_offset.x() + column * (m_tileSize.width() + m_separation.width()),
+                 m_offset.y() + row * (m_tileSize.height() + m_separation.height()),
+                 m_tileSize.width(), m_tileSize.height());
+}
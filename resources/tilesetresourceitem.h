@@ -0,0 +1,52 @@
+/*
+    Copyright (C) 2018  Alexander Roper
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef TILESETRESOURCEITEM_H
+#define TILESETRESOURCEITEM_H
+
+#include "resourceitem.h"
+#include <QRect>
+
+class SpriteResourceItem;
+class TileSetResourceItem : public ResourceItem
+{
+    Q_OBJECT
+
+public:
+    TileSetResourceItem();
+
+    void load(QJsonObject object) override;
+    QString filename() const override;
+
+    QPixmap thumbnail(int width = 100, int height = 100) const override;
+
+    SpriteResourceItem * sprite() const;
+    QSize tileSize() const;
+    int tileCount() const;
+    // area of the tile in the sprite of the tileset
+    QRect tileRect(int index) const;
+
+private:
+    QString m_spriteId;
+    QSize m_tileSize;
+    QPoint m_offset;
+    QSize m_separation;
+    int m_tileCount = 0;
+    mutable int m_columns = 0;
+};
+
+#endif // TILESETRESOURCEITEM_H
@@ -0,0 +1,150 @@
+/*
+    Copyright (C) 2018  Alexander Roper
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "editjournal.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QJsonDocument>
+#include <QtConcurrent>
+#include <QDebug>
+
+static const int FLUSH_INTERVAL = 1000;
+
+EditJournal::EditJournal(QObject * parent)
+    : QObject { parent }
+{
+    m_timer.setInterval(FLUSH_INTERVAL);
+    connect(&m_timer, &QTimer::timeout, this, &EditJournal::flush);
+}
+
+EditJournal::~EditJournal()
+{
+    m_flushing.waitForFinished();
+}
+
+void EditJournal::open(QString filename)
+{
+    close();
+
+    m_filename = filename;
+    QDir().mkpath(QFileInfo(filename).absolutePath());
+
+    // a journal still present means the previous session did not close properly
+    QFile f(filename);
+    if (f.open(QFile::ReadOnly))
+    {
+        while (!f.atEnd())
+        {
+            auto line = f.readLine();
+            auto doc = QJsonDocument::fromJson(line);
+            if (doc.isObject())
+            {
+                m_recovered.push_back(doc.object());
+            }
+        }
+        f.close();
+    }
+
+    if (!f.open(QFile::WriteOnly | QFile::Truncate))
+    {
+        qCritical() << "Can't open file" << filename << "in write only mode";
+        m_filename.clear();
+        return;
+    }
+    f.close();
+
+    m_timer.start();
+}
+
+void EditJournal::close()
+{
+    if (m_filename.isEmpty())
+        return;
+
+    m_timer.stop();
+    m_flushing.waitForFinished();
+    m_pending.clear();
+    m_recovered.clear();
+
+    QFile(m_filename).remove();
+    m_filename.clear();
+}
+
+QMap<QString, QVector<QJsonObject>> EditJournal::recoveredEntries() const
+{
+    QMap<QString, QVector<QJsonObject>> entries;
+    for (auto & entry : m_recovered)
+    {
+        auto id = entry["resource"].toString();
+        if (entry["op"].toString() == "saved")
+        {
+            // everything before was written in the resource file
+            entries.remove(id);
+        }
+        else
+        {
+            entries[id].push_back(entry);
+        }
+    }
+    return entries;
+}
+
+void EditJournal::clearRecoveredEntries()
+{
+    m_recovered.clear();
+}
+
+void EditJournal::append(QString resourceId, QJsonObject entry)
+{
+    if (m_filename.isEmpty())
+        return;
+
+    entry["resource"] = resourceId;
+    m_pending += QJsonDocument(entry).toJson(QJsonDocument::Compact);
+    m_pending += '\n';
+}
+
+void EditJournal::markSaved(QString resourceId)
+{
+    QJsonObject entry;
+    entry["op"] = "saved";
+    append(resourceId, entry);
+}
+
+void EditJournal::flush()
+{
+    // the previous write is still running, the entries will go with the next one
+    if (m_pending.isEmpty() || m_flushing.isRunning())
+        return;
+
+    QByteArray data;
+    data.swap(m_pending);
+
+    QString filename = m_filename;
+    m_flushing = QtConcurrent::run([filename, data]() {
+        QFile f(filename);
+        if (!f.open(QFile::WriteOnly | QFile::Append))
+        {
+            qCritical() << "Can't open file" << filename << "in append mode";
+            return;
+        }
+        f.write(data);
+        f.close();
+    });
+}
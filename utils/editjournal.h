@@ -0,0 +1,61 @@
+/*
+    Copyright (C) 2018  Alexander Roper
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef EDITJOURNAL_H
+#define EDITJOURNAL_H
+
+#include <QObject>
+#include <QJsonObject>
+#include <QFuture>
+#include <QTimer>
+#include <QMap>
+#include <QVector>
+
+// Append-only log of the unsaved edits done in the editors.
+// The pending entries are written to the disk in the background
+// on a timer, and the file is removed when the project is closed,
+// so a journal found when a project is opened means a crash happened.
+class EditJournal : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit EditJournal(QObject * parent = nullptr);
+    ~EditJournal();
+
+    void open(QString filename);
+    void close();
+
+    // entries of the previous session which were not saved, by resource id
+    QMap<QString, QVector<QJsonObject>> recoveredEntries() const;
+    void clearRecoveredEntries();
+
+public slots:
+    void append(QString resourceId, QJsonObject entry);
+    void markSaved(QString resourceId);
+    void flush();
+
+private:
+    QString m_filename;
+    QByteArray m_pending;
+    QFuture<void> m_flushing;
+    QTimer m_timer;
+    QVector<QJsonObject> m_recovered;
+};
+
+#endif // EDITJOURNAL_H
@@ -0,0 +1,155 @@
+/*
+    Copyright (C) 2018  Alexander Roper
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "jsonwriter.h"
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QStringList>
+
+static QByteArray scalarToJson(const QJsonValue & value)
+{
+    auto json = QJsonDocument(QJsonArray { value }).toJson(QJsonDocument::Compact);
+    // remove the surrounding brackets
+    return json.mid(1, json.size() - 2);
+}
+
+JsonWriter::JsonWriter(QIODevice * device)
+    : m_device { device }
+{
+}
+
+void JsonWriter::beginObject()
+{
+    beginValue();
+    write("{\n");
+    m_empty.push_back(true);
+}
+
+void JsonWriter::endObject()
+{
+    if (!m_empty.takeLast())
+        write("\n");
+    write(indentation() + "}");
+
+    if (m_empty.isEmpty())
+        write("\n");
+}
+
+void JsonWriter::beginArray()
+{
+    beginValue();
+    write("[\n");
+    m_empty.push_back(true);
+}
+
+void JsonWriter::endArray()
+{
+    if (!m_empty.takeLast())
+        write("\n");
+    write(indentation() + "]");
+
+    if (m_empty.isEmpty())
+        write("\n");
+}
+
+void JsonWriter::key(const QString & key)
+{
+    if (!m_empty.last())
+        write(",\n");
+    m_empty.last() = false;
+
+    write(indentation() + scalarToJson(key) + ": ");
+    m_afterKey = true;
+}
+
+void JsonWriter::value(const QJsonValue & value)
+{
+    QByteArray json;
+    if (value.isObject() || value.isArray())
+    {
+        auto doc = value.isObject() ? QJsonDocument(value.toObject()) : QJsonDocument(value.toArray());
+        json = doc.toJson(QJsonDocument::Indented);
+        json.chop(1);
+        json.replace("\n", "\n" + indentation());
+    }
+    else
+    {
+        json = scalarToJson(value);
+    }
+
+    beginValue();
+    write(json);
+
+    if (m_empty.isEmpty())
+        write("\n");
+}
+
+void JsonWriter::writeObject(const QJsonObject & object, const QJsonObject & overrides, const QMap<QString, Member> & streamed)
+{
+    QStringList keys = object.keys() + overrides.keys() + streamed.keys();
+    keys.sort();
+    keys.removeDuplicates();
+
+    beginObject();
+    for (auto & k : keys)
+    {
+        key(k);
+        if (streamed.contains(k))
+            streamed[k]();
+        else if (overrides.contains(k))
+            value(overrides[k]);
+        else
+            value(object[k]);
+    }
+    endObject();
+}
+
+bool JsonWriter::hasError() const
+{
+    return m_error;
+}
+
+void JsonWriter::beginValue()
+{
+    if (m_afterKey)
+    {
+        m_afterKey = false;
+        return;
+    }
+
+    // top level value
+    if (m_empty.isEmpty())
+        return;
+
+    if (!m_empty.last())
+        write(",\n");
+    m_empty.last() = false;
+
+    write(indentation());
+}
+
+void JsonWriter::write(const QByteArray & data)
+{
+    if (m_device->write(data) != data.size())
+        m_error = true;
+}
+
+QByteArray JsonWriter::indentation() const
+{
+    return QByteArray(4 * m_empty.size(), ' ');
+}
@@ -0,0 +1,64 @@
+/*
+    Copyright (C) 2018  Alexander Roper
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef JSONWRITER_H
+#define JSONWRITER_H
+
+#include <QIODevice>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QMap>
+#include <QVector>
+#include <functional>
+
+// Writes a JSON document directly into a device, with the same
+// formatting as QJsonDocument::Indented, so huge arrays never have
+// to be built in memory before being saved.
+class JsonWriter
+{
+public:
+    using Member = std::function<void()>;
+
+    explicit JsonWriter(QIODevice * device);
+
+    void beginObject();
+    void endObject();
+    void beginArray();
+    void endArray();
+
+    void key(const QString & key);
+    void value(const QJsonValue & value);
+
+    // Writes the members of "object", replaced by "overrides" and by the
+    // ones written by the "streamed" callbacks, in QJsonObject key order.
+    void writeObject(const QJsonObject & object, const QJsonObject & overrides = {}, const QMap<QString, Member> & streamed = {});
+
+    bool hasError() const;
+
+private:
+    void beginValue();
+    void write(const QByteArray & data);
+    QByteArray indentation() const;
+
+    QIODevice * m_device;
+    QVector<bool> m_empty;
+    bool m_afterKey = false;
+    bool m_error = false;
+};
+
+#endif // JSONWRITER_H
@@ -0,0 +1,186 @@
+/*
+    Copyright (C) 2018  Alexander Roper
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "localhistory.h"
+#include "gamesettings.h"
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QDebug>
+
+// a full content is stored at least every MAX_DELTA_CHAIN versions
+static const int MAX_DELTA_CHAIN = 32;
+static const char FULL_CONTENT = 'F';
+static const char DELTA_CONTENT = 'D';
+
+static QString hashOf(const QByteArray & data)
+{
+    return QString::fromLatin1(QCryptographicHash::hash(data, QCryptographicHash::Sha1).toHex());
+}
+
+static QByteArray makeDelta(const QByteArray & base, const QByteArray & data)
+{
+    int maxLength = qMin(base.size(), data.size());
+
+    int prefix = 0;
+    while (prefix < maxLength && base[prefix] == data[prefix])
+        prefix++;
+
+    int suffix = 0;
+    while (suffix < maxLength - prefix && base[base.size() - suffix - 1] == data[data.size() - suffix - 1])
+        suffix++;
+
+    QByteArray delta;
+    QDataStream stream(&delta, QIODevice::WriteOnly);
+    stream << static_cast<quint32>(prefix) << static_cast<quint32>(suffix) << data.mid(prefix, data.size() - prefix - suffix);
+    return delta;
+}
+
+static QByteArray applyDelta(const QByteArray & base, const QByteArray & delta)
+{
+    quint32 prefix = 0;
+    quint32 suffix = 0;
+    QByteArray middle;
+    QDataStream stream(delta);
+    stream >> prefix >> suffix >> middle;
+
+    return base.left(static_cast<int>(prefix)) + middle + base.right(static_cast<int>(suffix));
+}
+
+void LocalHistory::record(QString filename, QByteArray data)
+{
+    auto versions = timeline(filename);
+    auto hash = hashOf(data);
+    if (!versions.isEmpty() && versions.first().hash == hash)
+    {
+        // nothing changed since the last version
+        return;
+    }
+
+    int depth = 0;
+    QString blob = blobFilename(hash);
+    if (QFile::exists(blob))
+    {
+        // same content already stored, reuse it
+        QFile f(blob);
+        if (f.open(QFile::ReadOnly))
+        {
+            if (f.read(1) == QByteArray(1, DELTA_CONTENT))
+                depth = MAX_DELTA_CHAIN;
+            f.close();
+        }
+    }
+    else
+    {
+        QByteArray stored;
+        if (!versions.isEmpty() && versions.first().depth + 1 < MAX_DELTA_CHAIN)
+        {
+            auto & base = versions.first();
+            stored = DELTA_CONTENT + base.hash.toLatin1() + qCompress(makeDelta(content(base.hash), data));
+            depth = base.depth + 1;
+        }
+        else
+        {
+            stored = FULL_CONTENT + qCompress(data);
+        }
+
+        QDir().mkpath(QFileInfo(blob).absolutePath());
+        QFile f(blob);
+        if (!f.open(QFile::WriteOnly))
+        {
+            qCritical() << "Can't open file" << blob << "in write only mode";
+            return;
+        }
+        f.write(stored);
+        f.close();
+    }
+
+    QString timelineFile = timelineFilename(filename);
+    QDir().mkpath(QFileInfo(timelineFile).absolutePath());
+    QFile f(timelineFile);
+    if (!f.open(QFile::WriteOnly | QFile::Append))
+    {
+        qCritical() << "Can't open file" << timelineFile << "in append mode";
+        return;
+    }
+    f.write(QString("%1 %2 %3\n").arg(QDateTime::currentMSecsSinceEpoch()).arg(hash).arg(depth).toLatin1());
+    f.close();
+}
+
+QVector<LocalHistory::Version> LocalHistory::timeline(QString filename)
+{
+    QVector<Version> versions;
+
+    QFile f(timelineFilename(filename));
+    if (!f.open(QFile::ReadOnly))
+    {
+        return versions;
+    }
+
+    while (!f.atEnd())
+    {
+        auto fields = QString::fromLatin1(f.readLine()).trimmed().split(' ');
+        if (fields.size() != 3)
+            continue;
+
+        Version version;
+        version.time = QDateTime::fromMSecsSinceEpoch(fields[0].toLongLong());
+        version.hash = fields[1];
+        version.depth = fields[2].toInt();
+        versions.prepend(version);
+    }
+    f.close();
+
+    return versions;
+}
+
+QByteArray LocalHistory::content(QString hash)
+{
+    QFile f(blobFilename(hash));
+    if (!f.open(QFile::ReadOnly))
+    {
+        qCritical() << "Can't open file" << f.fileName() << "in read only mode";
+        return {};
+    }
+    auto stored = f.readAll();
+    f.close();
+
+    if (stored.startsWith(DELTA_CONTENT))
+    {
+        auto baseHash = QString::fromLatin1(stored.mid(1, 40));
+        return applyDelta(content(baseHash), qUncompress(stored.mid(41)));
+    }
+    return qUncompress(stored.mid(1));
+}
+
+QString LocalHistory::historyPath()
+{
+    return GameSettings::rootPath() + "/.gmlinux/history";
+}
+
+QString LocalHistory::blobFilename(QString hash)
+{
+    return QString("%1/objects/%2/%3").arg(historyPath(), hash.left(2), hash.mid(2));
+}
+
+QString LocalHistory::timelineFilename(QString filename)
+{
+    return QString("%1/timelines/%2").arg(historyPath(), hashOf(filename.toUtf8()));
+}
@@ -0,0 +1,55 @@
+/*
+    Copyright (C) 2018  Alexander Roper
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef LOCALHISTORY_H
+#define LOCALHISTORY_H
+
+#include <QString>
+#include <QByteArray>
+#include <QDateTime>
+#include <QVector>
+
+// Versions of the project files kept in .gmlinux/history.
+// Contents are stored once by hash, and a version is stored as a delta
+// against the previous version of the same file when possible.
+class LocalHistory
+{
+public:
+    LocalHistory() = delete;
+
+    struct Version
+    {
+        QDateTime time;
+        QString hash;
+        int depth = 0; // number of deltas to apply from the last full content
+    };
+
+    // filename is relative to the project root,
+    // only called from the GUI thread, nothing is locked
+    static void record(QString filename, QByteArray data);
+    // newest version first
+    static QVector<Version> timeline(QString filename);
+    static QByteArray content(QString hash);
+
+private:
+    static QString historyPath();
+    static QString blobFilename(QString hash);
+    static QString timelineFilename(QString filename);
+};
+
+#endif // LOCALHISTORY_H
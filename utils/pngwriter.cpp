@@ -0,0 +1,164 @@
+/*
+    Copyright (C) 2018  Alexander Roper
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "pngwriter.h"
+#include <QtConcurrent>
+#include <QtEndian>
+#include <QThread>
+#include <zlib.h>
+
+static QByteArray bigEndian(quint32 value)
+{
+    QByteArray data(4, 0);
+    qToBigEndian(value, data.data());
+    return data;
+}
+
+PngWriter::PngWriter(QIODevice * device, const QSize & size)
+    : m_device { device }
+    , m_size { size }
+    , m_maxPending { qMax(1, QThread::idealThreadCount()) }
+    , m_adler { quint32(adler32(0, nullptr, 0)) }
+{
+}
+
+bool PngWriter::begin()
+{
+    if (m_size.isEmpty())
+    {
+        m_error = true;
+        return false;
+    }
+
+    if (m_device->write("\x89PNG\r\n\x1a\n", 8) != 8)
+        m_error = true;
+
+    // 8 bits RGBA, not interlaced
+    QByteArray header = bigEndian(m_size.width()) + bigEndian(m_size.height());
+    header.append(char(8));
+    header.append(char(6));
+    header.append(3, char(0));
+    writeChunk("IHDR", header);
+
+    // the zlib header, the deflate blocks of the bands come next
+    writeChunk("IDAT", QByteArray("\x78\x9c", 2));
+    return !m_error;
+}
+
+void PngWriter::writeBand(const QImage & band)
+{
+    if (band.width() != m_size.width() || m_rows + band.height() > m_size.height())
+    {
+        m_error = true;
+        return;
+    }
+    m_rows += band.height();
+
+    // the blocks are written in order, once the oldest is compressed
+    m_pending.enqueue(QtConcurrent::run(&PngWriter::compress, band));
+    while (m_pending.size() > m_maxPending)
+    {
+        writeBlock(m_pending.dequeue().result());
+    }
+}
+
+bool PngWriter::end()
+{
+    while (!m_pending.isEmpty())
+    {
+        writeBlock(m_pending.dequeue().result());
+    }
+
+    if (m_rows != m_size.height())
+        m_error = true;
+
+    // an empty final block, then the checksum of the whole stream
+    QByteArray trailer("\x03\x00", 2);
+    trailer.append(bigEndian(m_adler));
+    writeChunk("IDAT", trailer);
+    writeChunk("IEND", QByteArray());
+    return !m_error;
+}
+
+bool PngWriter::hasError() const
+{
+    return m_error;
+}
+
+PngWriter::Block PngWriter::compress(const QImage & band)
+{
+    auto image = band.convertToFormat(QImage::Format_RGBA8888);
+    int stride = image.width() * 4;
+
+    // the "sub" filter only needs the row itself
+    QByteArray raw((stride + 1) * image.height(), Qt::Uninitialized);
+    auto out = reinterpret_cast<uchar*>(raw.data());
+    for (int y = 0; y < image.height(); y++)
+    {
+        auto line = image.constScanLine(y);
+        *out++ = 1;
+        for (int i = 0; i < 4; i++)
+            out[i] = line[i];
+        for (int i = 4; i < stride; i++)
+            out[i] = uchar(line[i] - line[i - 4]);
+        out += stride;
+    }
+
+    Block block;
+    block.length = raw.size();
+    block.adler = adler32(adler32(0, nullptr, 0), reinterpret_cast<const Bytef*>(raw.constData()), uInt(raw.size()));
+    block.error = false;
+
+    // raw deflate, flushed on a byte boundary so the bands can be concatenated
+    z_stream stream = {};
+    if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+    {
+        block.error = true;
+        return block;
+    }
+
+    block.data.resize(int(deflateBound(&stream, uLong(raw.size()))) + 16);
+    stream.next_in = reinterpret_cast<Bytef*>(raw.data());
+    stream.avail_in = uInt(raw.size());
+    stream.next_out = reinterpret_cast<Bytef*>(block.data.data());
+    stream.avail_out = uInt(block.data.size());
+    if (deflate(&stream, Z_SYNC_FLUSH) != Z_OK || stream.avail_in != 0)
+        block.error = true;
+    block.data.resize(block.data.size() - int(stream.avail_out));
+    deflateEnd(&stream);
+
+    return block;
+}
+
+void PngWriter::writeBlock(const Block & block)
+{
+    if (block.error)
+        m_error = true;
+
+    m_adler = quint32(adler32_combine(m_adler, block.adler, z_off_t(block.length)));
+    writeChunk("IDAT", block.data);
+}
+
+void PngWriter::writeChunk(const QByteArray & type, const QByteArray & data)
+{
+    auto crc = crc32(0, reinterpret_cast<const Bytef*>(type.constData()), uInt(type.size()));
+    crc = crc32(crc, reinterpret_cast<const Bytef*>(data.constData()), uInt(data.size()));
+
+    QByteArray chunk = bigEndian(quint32(data.size())) + type + data + bigEndian(quint32(crc));
+    if (m_device->write(chunk) != chunk.size())
+        m_error = true;
+}
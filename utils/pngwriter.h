@@ -0,0 +1,63 @@
+/*
+    Copyright (C) 2018  Alexander Roper
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef PNGWRITER_H
+#define PNGWRITER_H
+
+#include <QFuture>
+#include <QImage>
+#include <QIODevice>
+#include <QQueue>
+
+// Writes a PNG image into a device band by band, so huge images never
+// have to be in memory. Each band is filtered and compressed in a worker
+// thread, as a separate run of deflate blocks of the same zlib stream.
+class PngWriter
+{
+public:
+    PngWriter(QIODevice * device, const QSize & size);
+
+    bool begin();
+    // the bands are as wide as the image and are given from top to bottom
+    void writeBand(const QImage & band);
+    bool end();
+
+    bool hasError() const;
+
+private:
+    struct Block
+    {
+        QByteArray data;
+        quint32 adler;
+        qint64 length;
+        bool error;
+    };
+
+    static Block compress(const QImage & band);
+    void writeBlock(const Block & block);
+    void writeChunk(const QByteArray & type, const QByteArray & data);
+
+    QIODevice * m_device;
+    QSize m_size;
+    int m_rows = 0;
+    int m_maxPending;
+    QQueue<QFuture<Block>> m_pending;
+    quint32 m_adler;
+    bool m_error = false;
+};
+
+#endif // PNGWRITER_H
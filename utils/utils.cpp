@@ -17,6 +17,8 @@
 
 #include "utils.h"
 #include <QFile>
+#include <QSaveFile>
+#include <QtConcurrent>
 #include <QJsonDocument>
 #include <QJsonParseError>
 #include <QDebug>
@@ -81,6 +83,37 @@ bool Utils::writeFile(QString filename, QByteArray data)
     return true;
 }
 
+bool Utils::writeFile(QString filename, std::function<bool(QIODevice *)> writer)
+{
+    // the previous file is kept if anything goes wrong while streaming
+    QSaveFile f(filename);
+    if (!f.open(QFile::WriteOnly))
+    {
+        qCritical() << __PRETTY_FUNCTION__ << "Can't open file" << filename;
+        return false;
+    }
+
+    if (!writer(&f))
+    {
+        qCritical() << __PRETTY_FUNCTION__ << "Can't write file" << filename;
+        f.cancelWriting();
+    }
+
+    return f.commit();
+}
+
+QFuture<bool> Utils::writeFilesAsync(QVector<QPair<QString, QByteArray>> files)
+{
+    return QtConcurrent::run([files]() {
+        bool ok = true;
+        for (auto & file : files)
+        {
+            ok = writeFile(file.first, file.second) && ok;
+        }
+        return ok;
+    });
+}
+
 // RESOURCES
 
 static QMap<QString, ResourceType> resourcesTypesStrings = {
@@ -105,8 +138,12 @@ static QMap<QString, ResourceType> resourcesTypesStrings = {
     { "GMRBackgroundLayer", ResourceType::BackgroundLayer,  },
     { "GMRInstance",        ResourceType::ObjectInstance,   },
     { "GMRInstanceLayer",   ResourceType::InstanceLayer,    },
+    { "GMRView",            ResourceType::RoomView,         },
     { "GMRoom",             ResourceType::Room              },
+    { "GMRTileLayer",       ResourceType::TileLayer,        },
+    { "GMRoomPhysicsSettings", ResourceType::RoomPhysicsSettings, },
     { "GMRoomSettings",     ResourceType::RoomSettings,     },
+    { "GMRoomViewSettings", ResourceType::RoomViewSettings, },
     { "GMScript",           ResourceType::Script            },
     { "GMShader",           ResourceType::Shader,           },
     { "GMSound",            ResourceType::Sound             },
@@ -22,7 +22,12 @@
 #include <QJsonObject>
 #include <QJsonValue>
 #include <QJsonArray>
+#include <QIODevice>
+#include <QFuture>
+#include <QPair>
+#include <QVector>
 #include <type_traits>
+#include <functional>
 
 #include "resources/resourceitem.h"
 
@@ -36,6 +41,9 @@ public:
     static QString readFile(QString filename);
     static bool writeFile(QString filename, QJsonObject object);
     static bool writeFile(QString filename, QByteArray data);
+    static bool writeFile(QString filename, std::function<bool(QIODevice *)> writer);
+    // writes all the files in a worker thread
+    static QFuture<bool> writeFilesAsync(QVector<QPair<QString, QByteArray>> files);
 
     // Resources
     static QString resourceTypeToString(ResourceType type);
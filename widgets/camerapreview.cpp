@@ -0,0 +1,130 @@
+/*
+    Copyright (C) 2018  Alexander Roper
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "camerapreview.h"
+#include "graphics/graphicsroomview.h"
+#include "graphics/graphicslayer.h"
+#include <QPainter>
+
+// in milliseconds, changes are gathered before being drawn
+static const int UPDATE_DELAY = 100;
+
+CameraPreview::CameraPreview(QWidget * parent)
+    : QWidget { parent }
+{
+    m_updateTimer.setSingleShot(true);
+    connect(&m_updateTimer, &QTimer::timeout, this, &CameraPreview::render);
+}
+
+void CameraPreview::setView(GraphicsRoomView * view)
+{
+    if (view == m_view)
+        return;
+
+    disconnect(m_connection);
+    m_view = view;
+    if (m_view)
+        m_connection = connect(m_view, &GraphicsRoomView::contentChanged, this, &CameraPreview::contentChanged);
+    render();
+}
+
+void CameraPreview::setCamera(const QRect & camera)
+{
+    if (camera == m_camera)
+        return;
+
+    m_camera = camera;
+    render();
+}
+
+QSize CameraPreview::sizeHint() const
+{
+    return QSize(200, 150);
+}
+
+void CameraPreview::paintEvent(QPaintEvent * event)
+{
+    Q_UNUSED(event)
+
+    QPainter painter(this);
+    painter.fillRect(rect(), palette().dark());
+    if (m_image.isNull())
+    {
+        painter.drawText(rect(), Qt::AlignCenter, "No camera");
+        return;
+    }
+
+    painter.drawImage(imageRect(), m_image);
+}
+
+void CameraPreview::resizeEvent(QResizeEvent * event)
+{
+    QWidget::resizeEvent(event);
+
+    if (!m_updateTimer.isActive())
+        m_updateTimer.start(UPDATE_DELAY);
+}
+
+void CameraPreview::contentChanged(const QRectF & rect)
+{
+    // the changes out of the camera don't matter
+    if (!rect.isNull() && !rect.intersects(m_camera))
+        return;
+
+    if (!m_updateTimer.isActive())
+        m_updateTimer.start(UPDATE_DELAY);
+}
+
+void CameraPreview::render()
+{
+    m_updateTimer.stop();
+
+    if (m_view == nullptr || m_camera.isEmpty())
+    {
+        m_image = QImage();
+        update();
+        return;
+    }
+
+    // one pixel of the image for each pixel of the widget
+    QSize imageSize = QSizeF(m_camera.size()).scaled(QSizeF(size()), Qt::KeepAspectRatio).toSize().expandedTo(QSize(1, 1));
+    qreal scale = qreal(imageSize.width()) / m_camera.width();
+    m_image = QImage(imageSize, QImage::Format_ARGB32_Premultiplied);
+    m_image.fill(Qt::black);
+
+    // the layers only draw what intersects the camera, zoomed out
+    // they use their reduced images; as in the game, none is faded
+    QPainter painter(&m_image);
+    painter.setRenderHint(QPainter::SmoothPixmapTransform);
+    painter.scale(scale, scale);
+    painter.translate(-m_camera.topLeft());
+    painter.fillRect(QRect(QPoint(0, 0), m_view->roomSize()) & m_camera, Qt::white);
+    for (auto & layer : m_view->layers())
+    {
+        layer->paintCached(&painter, m_camera, true, false);
+    }
+    painter.end();
+
+    update();
+}
+
+QRectF CameraPreview::imageRect() const
+{
+    QSizeF size = QSizeF(m_image.size()).scaled(QSizeF(this->size()), Qt::KeepAspectRatio);
+    QPointF topLeft((width() - size.width()) / 2, (height() - size.height()) / 2);
+    return QRectF(topLeft, size);
+}
@@ -0,0 +1,58 @@
+/*
+    Copyright (C) 2018  Alexander Roper
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef CAMERAPREVIEW_H
+#define CAMERAPREVIEW_H
+
+#include <QWidget>
+#include <QImage>
+#include <QPointer>
+#include <QTimer>
+
+class GraphicsRoomView;
+// what a camera of the room sees, only its part of the room is drawn
+class CameraPreview : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit CameraPreview(QWidget * parent = nullptr);
+
+    void setView(GraphicsRoomView * view);
+    // in room coordinates, a null rect for no camera
+    void setCamera(const QRect & camera);
+    QSize sizeHint() const override;
+
+protected:
+    void paintEvent(QPaintEvent * event) override;
+    void resizeEvent(QResizeEvent * event) override;
+
+private slots:
+    void contentChanged(const QRectF & rect);
+    void render();
+
+private:
+    QRectF imageRect() const;
+
+    QPointer<GraphicsRoomView> m_view;
+    QMetaObject::Connection m_connection;
+    QRect m_camera;
+    QImage m_image;
+    QTimer m_updateTimer;
+};
+
+#endif // CAMERAPREVIEW_H
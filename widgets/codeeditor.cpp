@@ -32,6 +32,7 @@ CodeEditor::CodeEditor(QWidget *parent)
     layout->addWidget(textEdit);
 
     connect(textEdit, &QsciScintilla::modificationChanged, this, &CodeEditor::dirtyChanged);
+    connect(textEdit, &QsciScintillaBase::SCN_MODIFIED, this, &CodeEditor::onTextModified);
 }
 
 void CodeEditor::setCode(QString code)
@@ -46,6 +47,12 @@ QString CodeEditor::getCode() const
     return textEdit->text();
 }
 
+void CodeEditor::replaceCode(QString code)
+{
+    textEdit->selectAll();
+    textEdit->replaceSelectedText(code);
+}
+
 void CodeEditor::setDirty(bool dirty)
 {
     if (textEdit->isModified() != dirty)
@@ -58,3 +65,42 @@ void CodeEditor::setReadOnly(bool ro)
 {
     textEdit->setReadOnly(ro);
 }
+
+void CodeEditor::replay(const QJsonObject & operation)
+{
+    auto op = operation["op"].toString();
+    auto position = static_cast<unsigned long>(operation["pos"].toInt());
+    if (op == "insert")
+    {
+        auto text = QByteArray::fromBase64(operation["text"].toString().toLatin1());
+        textEdit->SendScintilla(QsciScintillaBase::SCI_INSERTTEXT, position, text.constData());
+    }
+    else if (op == "remove")
+    {
+        textEdit->SendScintilla(QsciScintillaBase::SCI_DELETERANGE, position, static_cast<long>(operation["length"].toInt()));
+    }
+}
+
+void CodeEditor::onTextModified(int position, int modificationType, const char * text, int length)
+{
+    // only the changes are sent, not the whole buffer
+    QJsonObject operation;
+    if (modificationType & QsciScintillaBase::SC_MOD_INSERTTEXT)
+    {
+        operation["op"] = "insert";
+        operation["pos"] = position;
+        operation["text"] = QString::fromLatin1(QByteArray(text, length).toBase64());
+    }
+    else if (modificationType & QsciScintillaBase::SC_MOD_DELETETEXT)
+    {
+        operation["op"] = "remove";
+        operation["pos"] = position;
+        operation["length"] = length;
+    }
+    else
+    {
+        return;
+    }
+
+    emit edited(operation);
+}
@@ -19,6 +19,7 @@
 #define CODEEDITOR_H
 
 #include <QWidget>
+#include <QJsonObject>
 #include <Qsci/qsciscintilla.h>
 
 class CodeEditor : public QWidget
@@ -29,12 +30,21 @@ public:
 
     void setCode(QString code);
     QString getCode() const;
+    // unlike setCode, the change can be undone and makes the editor dirty
+    void replaceCode(QString code);
 
     void setDirty(bool dirty);
     void setReadOnly(bool ro);
 
+    // apply an operation emitted by edited()
+    void replay(const QJsonObject & operation);
+
 signals:
     void dirtyChanged(bool);
+    void edited(QJsonObject operation);
+
+private slots:
+    void onTextModified(int position, int modificationType, const char * text, int length);
 
 private:
     QsciScintilla * textEdit;
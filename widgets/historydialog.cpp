@@ -0,0 +1,78 @@
+/*
+    Copyright (C) 2018  Alexander Roper
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "historydialog.h"
+#include "widgets/codeeditor.h"
+#include <QVBoxLayout>
+#include <QDialogButtonBox>
+#include <QPushButton>
+#include <QListWidget>
+#include <QSplitter>
+
+HistoryDialog::HistoryDialog(QString filename)
+    : versions { LocalHistory::timeline(filename) }
+{
+    setWindowTitle(QString("Local history: %1").arg(filename));
+    resize(800, 500);
+
+    versionsList = new QListWidget;
+    versionsList->setFocusPolicy(Qt::NoFocus);
+    preview = new CodeEditor;
+    preview->setReadOnly(true);
+
+    auto splitter = new QSplitter;
+    splitter->addWidget(versionsList);
+    splitter->addWidget(preview);
+    splitter->setSizes({ 200, 600 });
+
+    auto buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel);
+    buttons->button(QDialogButtonBox::Ok)->setText("Restore");
+    buttons->button(QDialogButtonBox::Ok)->setEnabled(false);
+
+    auto layout = new QVBoxLayout(this);
+    layout->addWidget(splitter);
+    layout->addWidget(buttons);
+
+    for (auto & version : versions)
+    {
+        versionsList->addItem(version.time.toString(Qt::SystemLocaleLongDate));
+    }
+
+    connect(buttons, &QDialogButtonBox::accepted, this, &HistoryDialog::accept);
+    connect(buttons, &QDialogButtonBox::rejected, this, &HistoryDialog::reject);
+    connect(versionsList, &QListWidget::currentRowChanged, this, &HistoryDialog::showVersion);
+    connect(versionsList, &QListWidget::currentRowChanged, [buttons](int row) {
+        buttons->button(QDialogButtonBox::Ok)->setEnabled(row != -1);
+    });
+}
+
+QString HistoryDialog::code() const
+{
+    return preview->getCode();
+}
+
+void HistoryDialog::showVersion(int row)
+{
+    if (row < 0 || row >= versions.size())
+    {
+        preview->setCode({});
+        return;
+    }
+
+    preview->setCode(LocalHistory::content(versions[row].hash));
+}
@@ -0,0 +1,45 @@
+/*
+    Copyright (C) 2018  Alexander Roper
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef HISTORYDIALOG_H
+#define HISTORYDIALOG_H
+
+#include <QDialog>
+#include "utils/localhistory.h"
+
+class QListWidget;
+class CodeEditor;
+class HistoryDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    HistoryDialog(QString filename);
+
+    QString code() const;
+
+private slots:
+    void showVersion(int row);
+
+private:
+    QVector<LocalHistory::Version> versions;
+    QListWidget * versionsList = nullptr;
+    CodeEditor * preview = nullptr;
+};
+
+#endif // HISTORYDIALOG_H
@@ -0,0 +1,149 @@
+/*
+    Copyright (C) 2018  Alexander Roper
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "instancesearch.h"
+#include "resources/objectresourceitem.h"
+#include <QComboBox>
+#include <QLineEdit>
+#include <QCheckBox>
+#include <QLabel>
+#include <QListView>
+#include <QPushButton>
+#include <QFormLayout>
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QSignalBlocker>
+#include <algorithm>
+
+InstanceSearch::InstanceSearch(QWidget * parent)
+    : QWidget { parent }
+{
+    objectCombo = new QComboBox;
+    nameEdit = new QLineEdit;
+    nameEdit->setPlaceholderText("Part of the name");
+    nameEdit->setClearButtonEnabled(true);
+    visibleAreaCheck = new QCheckBox("Only in the visible area");
+    allRoomsCheck = new QCheckBox("In every room");
+
+    countLabel = new QLabel;
+    auto selectButton = new QPushButton("Select");
+    selectButton->setToolTip("Select the results found in this room");
+
+    resultsView = new QListView;
+    resultsView->setModel(&resultsModel);
+    // searches can find tens of thousands of instances
+    resultsView->setUniformItemSizes(true);
+    resultsView->setLayoutMode(QListView::Batched);
+
+    auto form = new QFormLayout;
+    form->addRow("Object:", objectCombo);
+    form->addRow("Name:", nameEdit);
+
+    auto countLayout = new QHBoxLayout;
+    countLayout->addWidget(countLabel, 1);
+    countLayout->addWidget(selectButton);
+
+    auto layout = new QVBoxLayout(this);
+    layout->addLayout(form);
+    layout->addWidget(visibleAreaCheck);
+    layout->addWidget(allRoomsCheck);
+    layout->addLayout(countLayout);
+    layout->addWidget(resultsView, 1);
+
+    // the index answers fast enough to search at each key
+    connect(objectCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &InstanceSearch::searchRequested);
+    connect(nameEdit, &QLineEdit::textChanged, this, &InstanceSearch::searchRequested);
+    connect(nameEdit, &QLineEdit::returnPressed, this, &InstanceSearch::searchRequested);
+    connect(visibleAreaCheck, &QCheckBox::toggled, this, &InstanceSearch::searchRequested);
+    connect(allRoomsCheck, &QCheckBox::toggled, this, [this](bool checked) {
+        // the visible area is the one of this room
+        visibleAreaCheck->setEnabled(!checked);
+        emit searchRequested();
+    });
+    connect(selectButton, &QPushButton::clicked, this, &InstanceSearch::selectResultsRequested);
+    connect(resultsView, &QListView::pressed, this, &InstanceSearch::activateResult);
+    connect(resultsView, &QListView::activated, this, &InstanceSearch::activateResult);
+}
+
+InstanceIndex::Query InstanceSearch::query() const
+{
+    InstanceIndex::Query query;
+    query.objectId = objectCombo->currentData().toString();
+    query.name = nameEdit->text();
+    return query;
+}
+
+bool InstanceSearch::visibleAreaOnly() const
+{
+    return visibleAreaCheck->isEnabled() && visibleAreaCheck->isChecked();
+}
+
+bool InstanceSearch::allRooms() const
+{
+    return allRoomsCheck->isChecked();
+}
+
+void InstanceSearch::setResults(const QVector<SearchResult> & results, bool showRooms)
+{
+    resultsModel.setResults(results, showRooms);
+    countLabel->setText(QString("%1 instance(s) found").arg(results.size()));
+}
+
+QVector<ObjectInstance*> InstanceSearch::results(RoomResourceItem * room) const
+{
+    return resultsModel.instancesIn(room);
+}
+
+void InstanceSearch::activateResult(const QModelIndex & index)
+{
+    auto room = resultsModel.room(index.row());
+    auto instance = resultsModel.instance(index.row());
+    if (room && instance)
+        emit resultActivated(room, instance);
+}
+
+void InstanceSearch::showEvent(QShowEvent * event)
+{
+    QWidget::showEvent(event);
+
+    // objects may have been added since the last time
+    fillObjects();
+}
+
+void InstanceSearch::fillObjects()
+{
+    QVector<ObjectResourceItem*> objects;
+    for (auto & id : ResourceItem::findAll(ResourceType::Object))
+    {
+        if (auto pObject = ResourceItem::get<ObjectResourceItem>(id))
+            objects.append(pObject);
+    }
+    std::sort(objects.begin(), objects.end(), [](ObjectResourceItem * a, ObjectResourceItem * b) {
+        return a->name().compare(b->name(), Qt::CaseInsensitive) < 0;
+    });
+
+    // the choice is kept, without searching again
+    QSignalBlocker blocker(objectCombo);
+    auto current = objectCombo->currentData().toString();
+    objectCombo->clear();
+    objectCombo->addItem("Any object", QString());
+    for (auto & pObject : objects)
+    {
+        objectCombo->addItem(pObject->name(), pObject->id());
+    }
+    objectCombo->setCurrentIndex(qMax(0, objectCombo->findData(current)));
+}
@@ -0,0 +1,69 @@
+/*
+    Copyright (C) 2018  Alexander Roper
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef INSTANCESEARCH_H
+#define INSTANCESEARCH_H
+
+#include <QWidget>
+#include "models/searchresultsmodel.h"
+#include "resources/dependencies/instanceindex.h"
+
+class QComboBox;
+class QLineEdit;
+class QCheckBox;
+class QLabel;
+class QListView;
+// the filters of a search on the instances, and its results;
+// the search itself is done by the owner on searchRequested
+class InstanceSearch : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit InstanceSearch(QWidget * parent = nullptr);
+
+    InstanceIndex::Query query() const;
+    bool visibleAreaOnly() const;
+    bool allRooms() const;
+
+    void setResults(const QVector<SearchResult> & results, bool showRooms);
+    QVector<ObjectInstance*> results(RoomResourceItem * room) const;
+
+signals:
+    void searchRequested();
+    void resultActivated(RoomResourceItem * room, ObjectInstance * instance);
+    void selectResultsRequested();
+
+protected:
+    void showEvent(QShowEvent * event) override;
+
+private slots:
+    void activateResult(const QModelIndex & index);
+
+private:
+    void fillObjects();
+
+    SearchResultsModel resultsModel;
+    QComboBox * objectCombo = nullptr;
+    QLineEdit * nameEdit = nullptr;
+    QCheckBox * visibleAreaCheck = nullptr;
+    QCheckBox * allRoomsCheck = nullptr;
+    QLabel * countLabel = nullptr;
+    QListView * resultsView = nullptr;
+};
+
+#endif // INSTANCESEARCH_H
@@ -0,0 +1,81 @@
+/*
+    Copyright (C) 2018  Alexander Roper
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "roomanalysisdialog.h"
+#include <QCheckBox>
+#include <QDialogButtonBox>
+#include <QFontDatabase>
+#include <QPlainTextEdit>
+#include <QVBoxLayout>
+
+RoomAnalysisDialog::RoomAnalysisDialog(const RoomAnalysis::Report & report, QWidget * parent)
+    : QDialog { parent }
+{
+    setWindowTitle(QString("Analysis: %1").arg(report.roomName));
+    resize(500, 500);
+
+    auto textEdit = new QPlainTextEdit(text(report));
+    textEdit->setReadOnly(true);
+    textEdit->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+
+    auto heatmapCheck = new QCheckBox("Show the heatmap on the room");
+    heatmapCheck->setChecked(true);
+
+    auto buttons = new QDialogButtonBox(QDialogButtonBox::Close);
+
+    auto layout = new QVBoxLayout(this);
+    layout->addWidget(textEdit);
+    layout->addWidget(heatmapCheck);
+    layout->addWidget(buttons);
+
+    connect(buttons, &QDialogButtonBox::rejected, this, &RoomAnalysisDialog::reject);
+    connect(heatmapCheck, &QCheckBox::toggled, this, &RoomAnalysisDialog::heatmapToggled);
+}
+
+QString RoomAnalysisDialog::text(const RoomAnalysis::Report & report)
+{
+    QString text;
+    text += QString("Instances:        %1 (%2 drawn)\n").arg(report.instanceCount).arg(report.drawnInstances);
+    text += QString("Unique sprites:   %1\n").arg(report.uniqueSprites);
+    text += QString("Texture pages:    %1\n").arg(report.texturePages);
+    text += QString("Draw batches:     %1\n").arg(report.drawBatches);
+    text += QString("Texture swaps:    %1\n").arg(report.textureSwaps);
+    text += QString("Collision pairs:  %1 (in cells of %2 pixels)\n").arg(report.collisionPairs).arg(report.cellSize);
+
+    if (!report.hotSpots.isEmpty())
+    {
+        text += "\nHot spots:\n";
+        for (auto & spot : report.hotSpots)
+        {
+            text += QString("  at %1, %2: %3 instances, %4 collision pairs\n")
+                    .arg(spot.area.x()).arg(spot.area.y()).arg(spot.instances).arg(spot.pairs);
+        }
+    }
+
+    if (!report.instancesPerObject.isEmpty())
+    {
+        text += "\nInstances per object:\n";
+        for (auto & count : report.instancesPerObject)
+        {
+            text += QString("  %1 %2\n").arg(count.second, 8).arg(count.first);
+        }
+    }
+
+    text += "\nThe pages are guessed from the texture groups and the sizes of the sprites,\n"
+            "the batches and swaps from the order of the layers and of their instances.";
+    return text;
+}
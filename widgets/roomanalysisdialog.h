@@ -0,0 +1,39 @@
+/*
+    Copyright (C) 2018  Alexander Roper
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef ROOMANALYSISDIALOG_H
+#define ROOMANALYSISDIALOG_H
+
+#include <QDialog>
+#include "graphics/roomanalysis.h"
+
+// the report of an analysis, the heatmap is shown on the room meanwhile
+class RoomAnalysisDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    RoomAnalysisDialog(const RoomAnalysis::Report & report, QWidget * parent = nullptr);
+
+signals:
+    void heatmapToggled(bool visible);
+
+private:
+    static QString text(const RoomAnalysis::Report & report);
+};
+
+#endif // ROOMANALYSISDIALOG_H
@@ -0,0 +1,215 @@
+/*
+    Copyright (C) 2018  Alexander Roper
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "roomminimap.h"
+#include "graphics/graphicsroomview.h"
+#include "graphics/graphicslayer.h"
+#include <QElapsedTimer>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QScrollBar>
+#include <QtMath>
+
+// in pixels, the largest side of the image of the room
+static const qreal MAX_SIZE = 512;
+// in pixels of the image, the size of the parts drawn again
+static const int CELL_SIZE = 32;
+// in milliseconds, changes are gathered before being drawn
+static const int UPDATE_DELAY = 100;
+// in milliseconds, the time given to each slice of drawing
+static const int DRAW_SLICE = 8;
+
+RoomMinimap::RoomMinimap(QWidget * parent)
+    : QWidget { parent }
+{
+    m_updateTimer.setSingleShot(true);
+    connect(&m_updateTimer, &QTimer::timeout, this, &RoomMinimap::drawDirtyCells);
+}
+
+void RoomMinimap::setView(GraphicsRoomView * view)
+{
+    if (view == m_view)
+        return;
+
+    for (auto & connection : m_connections)
+        disconnect(connection);
+    m_connections.clear();
+
+    m_view = view;
+    if (m_view)
+    {
+        m_connections.append(connect(m_view, &GraphicsRoomView::contentChanged, this, &RoomMinimap::markDirty));
+        for (auto scrollBar : { m_view->horizontalScrollBar(), m_view->verticalScrollBar() })
+        {
+            m_connections.append(connect(scrollBar, &QScrollBar::valueChanged, this, [this]() { update(); }));
+            m_connections.append(connect(scrollBar, &QScrollBar::rangeChanged, this, [this]() { update(); }));
+        }
+    }
+    reset();
+}
+
+QSize RoomMinimap::sizeHint() const
+{
+    return QSize(200, 200);
+}
+
+void RoomMinimap::paintEvent(QPaintEvent * event)
+{
+    Q_UNUSED(event)
+
+    QPainter painter(this);
+    painter.fillRect(rect(), palette().dark());
+    if (m_view == nullptr || m_image.isNull())
+        return;
+
+    auto target = imageRect();
+    painter.setRenderHint(QPainter::SmoothPixmapTransform);
+    painter.drawImage(target, m_image);
+
+    // the part of the room in the view
+    qreal factor = m_scale * target.width() / m_image.width();
+    auto visible = m_view->mapToScene(m_view->viewport()->rect()).boundingRect();
+    QRectF viewport(target.topLeft() + visible.topLeft() * factor, visible.size() * factor);
+    painter.setPen(QPen(Qt::red, 1));
+    painter.setBrush(Qt::NoBrush);
+    painter.drawRect(viewport & rect().adjusted(0, 0, -1, -1));
+}
+
+void RoomMinimap::mousePressEvent(QMouseEvent * event)
+{
+    if (m_view && !m_image.isNull() && event->button() == Qt::LeftButton)
+        m_view->centerOn(mapToScene(event->pos()));
+}
+
+void RoomMinimap::mouseMoveEvent(QMouseEvent * event)
+{
+    if (m_view && !m_image.isNull() && (event->buttons() & Qt::LeftButton))
+        m_view->centerOn(mapToScene(event->pos()));
+}
+
+void RoomMinimap::markDirty(const QRectF & rect)
+{
+    if (m_view == nullptr)
+        return;
+
+    if (rect.isNull())
+    {
+        // the room may have another size
+        reset();
+        return;
+    }
+
+    auto imageArea = QRectF(rect.topLeft() * m_scale, rect.size() * m_scale);
+    int left = qMax(0, qFloor(imageArea.left() / CELL_SIZE));
+    int top = qMax(0, qFloor(imageArea.top() / CELL_SIZE));
+    int right = qMin(m_columns - 1, qFloor(imageArea.right() / CELL_SIZE));
+    int bottom = qMin(m_rows - 1, qFloor(imageArea.bottom() / CELL_SIZE));
+    for (int y = top; y <= bottom; y++)
+    {
+        for (int x = left; x <= right; x++)
+            m_dirty.setBit(y * m_columns + x);
+    }
+
+    if (!m_updateTimer.isActive())
+        m_updateTimer.start(UPDATE_DELAY);
+}
+
+void RoomMinimap::drawDirtyCells()
+{
+    if (m_view == nullptr || m_image.isNull())
+        return;
+
+    auto layers = m_view->layers();
+
+    QElapsedTimer timer;
+    timer.start();
+    QPainter painter(&m_image);
+    painter.setRenderHint(QPainter::SmoothPixmapTransform);
+    for (int i = 0; i < m_dirty.size(); i++)
+    {
+        if (!m_dirty.testBit(i))
+            continue;
+
+        // the rest is drawn in the next slice
+        if (timer.elapsed() >= DRAW_SLICE)
+        {
+            m_updateTimer.start(0);
+            break;
+        }
+        m_dirty.clearBit(i);
+
+        QRect cell((i % m_columns) * CELL_SIZE, (i / m_columns) * CELL_SIZE, CELL_SIZE, CELL_SIZE);
+        cell &= m_image.rect();
+
+        painter.save();
+        painter.setClipRect(cell);
+        painter.setCompositionMode(QPainter::CompositionMode_Source);
+        painter.fillRect(cell, Qt::white);
+        painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
+        painter.scale(m_scale, m_scale);
+
+        // the lod image of the layers would be made again for each change
+        QRectF sceneRect(QPointF(cell.topLeft()) / m_scale, QSizeF(cell.size()) / m_scale);
+        for (auto & layer : layers)
+            layer->paintCached(&painter, sceneRect, false);
+        painter.restore();
+    }
+    painter.end();
+
+    update();
+}
+
+void RoomMinimap::reset()
+{
+    m_updateTimer.stop();
+
+    QSize roomSize = m_view ? m_view->roomSize() : QSize();
+    if (roomSize.isEmpty())
+    {
+        m_image = QImage();
+        m_dirty.clear();
+        update();
+        return;
+    }
+
+    m_scale = qMin(qreal(1), MAX_SIZE / qMax(roomSize.width(), roomSize.height()));
+    QSize imageSize = (QSizeF(roomSize) * m_scale).toSize().expandedTo(QSize(1, 1));
+    if (imageSize != m_image.size())
+        m_image = QImage(imageSize, QImage::Format_ARGB32_Premultiplied);
+    m_image.fill(Qt::white);
+
+    m_columns = (imageSize.width() + CELL_SIZE - 1) / CELL_SIZE;
+    m_rows = (imageSize.height() + CELL_SIZE - 1) / CELL_SIZE;
+    m_dirty = QBitArray(m_columns * m_rows, true);
+    m_updateTimer.start(0);
+    update();
+}
+
+QRectF RoomMinimap::imageRect() const
+{
+    // the image fills the widget, without changing its ratio
+    QSizeF size = QSizeF(m_image.size()).scaled(QSizeF(this->size()), Qt::KeepAspectRatio);
+    QPointF topLeft((width() - size.width()) / 2, (height() - size.height()) / 2);
+    return QRectF(topLeft, size);
+}
+
+QPointF RoomMinimap::mapToScene(const QPoint & pos) const
+{
+    auto target = imageRect();
+    qreal factor = m_scale * target.width() / m_image.width();
+    return (pos - target.topLeft()) / factor;
+}
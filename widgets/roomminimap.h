@@ -0,0 +1,64 @@
+/*
+    Copyright (C) 2018  Alexander Roper
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef ROOMMINIMAP_H
+#define ROOMMINIMAP_H
+
+#include <QWidget>
+#include <QBitArray>
+#include <QImage>
+#include <QPointer>
+#include <QTimer>
+
+class GraphicsRoomView;
+// the whole room at a low resolution, with the area seen in the view
+class RoomMinimap : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit RoomMinimap(QWidget * parent = nullptr);
+
+    void setView(GraphicsRoomView * view);
+    QSize sizeHint() const override;
+
+protected:
+    void paintEvent(QPaintEvent * event) override;
+    void mousePressEvent(QMouseEvent * event) override;
+    void mouseMoveEvent(QMouseEvent * event) override;
+
+private slots:
+    // only the cells of the image under the rect are drawn again
+    void markDirty(const QRectF & rect);
+    void drawDirtyCells();
+
+private:
+    void reset();
+    QRectF imageRect() const;
+    QPointF mapToScene(const QPoint & pos) const;
+
+    QPointer<GraphicsRoomView> m_view;
+    QVector<QMetaObject::Connection> m_connections;
+    QImage m_image;
+    qreal m_scale = 1;
+    int m_columns = 0;
+    int m_rows = 0;
+    QBitArray m_dirty;
+    QTimer m_updateTimer;
+};
+
+#endif // ROOMMINIMAP_H
@@ -0,0 +1,127 @@
+/*
+    Copyright (C) 2018  Alexander Roper
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "spritepreview.h"
+#include "resources/spriteresourceitem.h"
+#include "graphics/spriteanimator.h"
+#include "graphics/spritecache.h"
+#include <QMouseEvent>
+#include <QPainter>
+
+// in pixels, the size of the squares behind the sprite
+static const int CHECKER_SIZE = 8;
+
+SpritePreview::SpritePreview(SpriteResourceItem * sprite, QWidget * parent)
+    : QWidget { parent }
+    , m_sprite { sprite }
+{
+    connect(SpriteAnimator::instance(), &SpriteAnimator::framesReady, this, [this](const SpriteResourceItem * ready) {
+        if (ready == m_sprite)
+            update();
+    });
+}
+
+void SpritePreview::setPlaying(bool playing)
+{
+    m_playing = playing;
+    updateAnimation();
+    update();
+}
+
+bool SpritePreview::isPlaying() const
+{
+    return m_playing;
+}
+
+void SpritePreview::paintEvent(QPaintEvent * event)
+{
+    Q_UNUSED(event)
+
+    QPainter painter(this);
+    painter.fillRect(rect(), palette().window());
+
+    // the first frame is shown until the animation is decoded
+    auto pix = SpriteAnimator::instance()->framePixmap(m_sprite, m_frame);
+    if (pix.isNull())
+        pix = SpriteCache::pixmap(m_sprite);
+    if (pix.isNull())
+    {
+        painter.drawText(rect(), Qt::AlignCenter, "No image");
+        return;
+    }
+
+    // enlarged by a whole factor, so the pixels stay sharp
+    int zoom = qMax(1, qMin((width() - 20) / pix.width(), (height() - 40) / pix.height()));
+    QRect target(QPoint(0, 0), pix.size() * zoom);
+    target.moveCenter(rect().center());
+
+    QPixmap checker(CHECKER_SIZE * 2, CHECKER_SIZE * 2);
+    checker.fill(Qt::white);
+    QPainter checkerPainter(&checker);
+    checkerPainter.fillRect(0, 0, CHECKER_SIZE, CHECKER_SIZE, Qt::lightGray);
+    checkerPainter.fillRect(CHECKER_SIZE, CHECKER_SIZE, CHECKER_SIZE, CHECKER_SIZE, Qt::lightGray);
+    checkerPainter.end();
+    painter.fillRect(target, QBrush(checker));
+    painter.drawPixmap(target, pix);
+
+    auto text = QString("Frame %1 / %2, %3 fps%4").arg(m_frame + 1).arg(m_sprite->frameCount())
+            .arg(m_sprite->framesPerSecond()).arg(m_playing ? "" : " (paused)");
+    painter.drawText(rect().adjusted(10, 10, -10, -10), Qt::AlignBottom | Qt::AlignHCenter, text);
+}
+
+void SpritePreview::mousePressEvent(QMouseEvent * event)
+{
+    if (event->button() == Qt::LeftButton)
+        setPlaying(!m_playing);
+}
+
+void SpritePreview::showEvent(QShowEvent * event)
+{
+    QWidget::showEvent(event);
+    updateAnimation();
+}
+
+void SpritePreview::hideEvent(QHideEvent * event)
+{
+    QWidget::hideEvent(event);
+    updateAnimation();
+}
+
+void SpritePreview::animate()
+{
+    int frame = SpriteAnimator::instance()->frame(m_sprite);
+    if (frame != m_frame)
+    {
+        m_frame = frame;
+        update();
+    }
+}
+
+void SpritePreview::updateAnimation()
+{
+    // the shared timer only runs for the sprites on screen
+    auto animator = SpriteAnimator::instance();
+    if (m_playing && isVisible() && m_sprite->frameCount() > 1)
+    {
+        animator->addClient(this);
+        connect(animator, &SpriteAnimator::tick, this, &SpritePreview::animate, Qt::UniqueConnection);
+    }
+    else
+    {
+        animator->removeClient(this);
+    }
+}
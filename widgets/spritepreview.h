@@ -0,0 +1,50 @@
+/*
+    Copyright (C) 2018  Alexander Roper
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SPRITEPREVIEW_H
+#define SPRITEPREVIEW_H
+
+#include <QWidget>
+
+class SpriteResourceItem;
+// plays the animation of a sprite, a click pauses it
+class SpritePreview : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit SpritePreview(SpriteResourceItem * sprite, QWidget * parent = nullptr);
+
+    void setPlaying(bool playing);
+    bool isPlaying() const;
+
+protected:
+    void paintEvent(QPaintEvent * event) override;
+    void mousePressEvent(QMouseEvent * event) override;
+    void showEvent(QShowEvent * event) override;
+    void hideEvent(QHideEvent * event) override;
+
+private:
+    void animate();
+    void updateAnimation();
+
+    SpriteResourceItem * m_sprite;
+    int m_frame = 0;
+    bool m_playing = true;
+};
+
+#endif // SPRITEPREVIEW_H